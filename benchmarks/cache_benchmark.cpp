@@ -0,0 +1,931 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <span>
+#include <unordered_map>
+#include <numeric>
+#include <optional>
+#include <filesystem>
+
+#include "cache_system/buffer_pool.hpp"
+#include "cache_system/compressed_cache.hpp"
+#include "cache_system/concurrent_lru_cache.hpp"
+#include "cache_system/lru_cache.hpp"
+#include "cache_system/near_cache.hpp"
+#include "cache_system/sharded_lru_cache.hpp"
+#include "cache_system/swiss_index.hpp"
+#include "cache_system/tiered_cache.hpp"
+
+/**
+ * 缓存性能基准测试
+ *
+ * 用法: cache_benchmark [section]
+ *   lru        - LRUCache 容量扫描 (10 ~ 1M)，与旧的线性扫描实现对比
+ *   concurrent - 1/2/4/8/16 线程吞吐量：分片锁 vs 单一全局锁
+ *   policy     - LRU / CLOCK / SLRU / ARC 在 Zipf 与扫描混合负载下的命中率和耗时
+ *   admission  - TinyLFU 准入过滤在 Zipf 负载下的命中率对比
+ *   batch      - multi_get / multi_put 在不同批大小下每个键的耗时
+ *   negative   - 一半查找是不存在的键、加载函数耗时约 1 us 时，否定查找缓存省下的加载次数与耗时
+ *   index      - 1M 键下 SwissIndex 与 std::unordered_map 索引的插入/查找耗时和内存
+ *   readmostly - 95% 读负载下分片锁缓存与无锁读的 ConcurrentLRUCache 的吞吐量
+ *   near       - Zipf 热点读负载下直接读分片缓存与经过线程本地近缓存的吞吐量，及每个线程的近缓存命中率
+ *   recycle    - 持续淘汰时 put 的耗时：每次新分配值的缓冲区 vs 淘汰监听器回收到缓冲区池
+ *   stats      - 统计计数与采样计时的单次开销，以及一次 Zipf 负载的统计快照
+ *   tiered     - 内存只放 10% 键空间时，单层 LRUCache 与加上溢出文件的两层缓存的命中率和耗时
+ *   compress   - 三种整数序列的压缩比与解码吞吐量，以及相同内存预算下冷条目压缩缓存的命中率
+ *
+ * 不带参数时运行全部测试。
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // 不打印日志的小负载，避免输出开销干扰测量
+    struct Payload {
+        std::vector<int> data;
+
+        Payload(std::string_view, size_t size) : data(size) {}
+
+        // 使用缓冲区池中取出的缓冲区
+        Payload(std::vector<int>&& buffer, size_t size) : data(std::move(buffer)) { data.resize(size); }
+    };
+
+    // 旧实现：vector + find_if + rotate，仅作为对照组
+    template<typename Key, typename Value>
+    class LinearLRUCache {
+    private:
+        std::vector<std::pair<Key, Value>> cache;
+        size_t maxSize;
+
+    public:
+        explicit LinearLRUCache(size_t size) : maxSize(size) { cache.reserve(size); }
+
+        template<typename K, typename V>
+        void put(K&& key, V&& value) {
+            auto it = std::find_if(cache.begin(), cache.end(),
+                [&key](const auto& node) { return node.first == key; });
+            if (it != cache.end()) {
+                it->second = std::forward<V>(value);
+                std::rotate(it, it + 1, cache.end());
+                return;
+            }
+            if (cache.size() >= maxSize) {
+                cache.erase(cache.begin());
+            }
+            cache.emplace_back(std::forward<K>(key), std::forward<V>(value));
+        }
+
+        bool get(const Key& key) {
+            auto it = std::find_if(cache.begin(), cache.end(),
+                [&key](const auto& node) { return node.first == key; });
+            if (it == cache.end()) {
+                return false;
+            }
+            std::rotate(it, it + 1, cache.end());
+            return true;
+        }
+    };
+
+    // 固定随机种子生成的键序列：键空间为容量的 2 倍，约一半命中
+    std::vector<uint64_t> make_keys(size_t capacity, size_t count) {
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<uint64_t> dist(0, capacity * 2);
+        std::vector<uint64_t> keys(count);
+        for (auto& k : keys) {
+            k = dist(rng);
+        }
+        return keys;
+    }
+
+    template<typename Cache>
+    double run_mixed(Cache& cache, const std::vector<uint64_t>& keys, size_t& hits) {
+        auto start = Clock::now();
+        for (uint64_t k : keys) {
+            // 读写比约 3:1，未命中后回填
+            if (k % 4 == 0) {
+                cache.put(k, Payload("", 16));
+            } else if (cache.get(k)) {
+                ++hits;
+            } else {
+                cache.put(k, Payload("", 16));
+            }
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return elapsed / static_cast<double>(keys.size());
+    }
+
+    void benchmark_lru_capacity_sweep() {
+        std::cout << "\n=== LRUCache 容量扫描 ===\n";
+        std::cout << "容量        哈希索引ns/op   线性扫描ns/op   命中率\n";
+
+        for (size_t capacity = 10; capacity <= 1000000; capacity *= 10) {
+            const size_t ops = std::max<size_t>(capacity * 4, 200000);
+            auto keys = make_keys(capacity, ops);
+
+            CacheSystem::LRUCache<uint64_t, Payload> cache(capacity);
+            size_t hits = 0;
+            double hashedNs = run_mixed(cache, keys, hits);
+            double hitRate = static_cast<double>(hits) / static_cast<double>(ops);
+
+            std::cout << std::left << std::setw(12) << capacity
+                      << std::setw(16) << std::fixed << std::setprecision(1) << hashedNs;
+
+            // 线性实现在大容量下每次操作 O(n)，只在 10K 以内对比
+            if (capacity <= 10000) {
+                LinearLRUCache<uint64_t, Payload> linear(capacity);
+                std::vector<uint64_t> sample(keys.begin(),
+                                             keys.begin() + std::min<size_t>(keys.size(), 200000));
+                auto linearRun = [&] {
+                    auto start = Clock::now();
+                    for (uint64_t k : sample) {
+                        if (k % 4 == 0 || !linear.get(k)) {
+                            linear.put(k, Payload("", 16));
+                        }
+                    }
+                    return std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+                           / static_cast<double>(sample.size());
+                };
+                std::cout << std::setw(16) << linearRun();
+            } else {
+                std::cout << std::setw(16) << "-";
+            }
+            std::cout << std::setprecision(3) << hitRate << "\n";
+        }
+    }
+
+    // Zipf 分布采样：预先计算 CDF，二分查找
+    class ZipfGenerator {
+    private:
+        std::vector<double> cdf;
+        std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+    public:
+        ZipfGenerator(size_t n, double skew) : cdf(n) {
+            double sum = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+                cdf[i] = sum;
+            }
+            for (auto& c : cdf) {
+                c /= sum;
+            }
+        }
+
+        template<typename Rng>
+        uint64_t operator()(Rng& rng) {
+            auto it = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng));
+            return static_cast<uint64_t>(it - cdf.begin());
+        }
+    };
+
+    // Zipf 热点访问中每隔一段插入一次大范围顺序扫描
+    std::vector<uint64_t> make_scan_mixed_trace(size_t keySpace, size_t count, double skew) {
+        std::mt19937_64 rng(7);
+        ZipfGenerator zipf(keySpace, skew);
+        std::vector<uint64_t> trace;
+        trace.reserve(count);
+        uint64_t scanKey = keySpace;
+        while (trace.size() < count) {
+            for (size_t i = 0; i < 5000 && trace.size() < count; ++i) {
+                trace.push_back(zipf(rng));
+            }
+            for (size_t i = 0; i < 2000 && trace.size() < count; ++i) {
+                trace.push_back(scanKey++);  // 只出现一次的键
+            }
+        }
+        return trace;
+    }
+
+    std::vector<uint64_t> make_zipf_trace(size_t keySpace, size_t count, double skew) {
+        std::mt19937_64 rng(11);
+        ZipfGenerator zipf(keySpace, skew);
+        std::vector<uint64_t> trace(count);
+        for (auto& k : trace) {
+            k = zipf(rng);
+        }
+        return trace;
+    }
+
+    // 读穿模式回放：未命中时回填，返回 {命中率, ns/op}
+    template<template<typename> class Policy>
+    std::pair<double, double> replay(const std::vector<uint64_t>& trace, size_t capacity,
+                                     bool admission = false) {
+        CacheSystem::LRUCache<uint64_t, uint64_t, Policy> cache(capacity);
+        if (admission) {
+            cache.enable_admission_filter();
+        }
+        size_t hits = 0;
+        auto start = Clock::now();
+        for (uint64_t k : trace) {
+            if (cache.get(k)) {
+                ++hits;
+            } else {
+                cache.put(k, k);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return {static_cast<double>(hits) / static_cast<double>(trace.size()),
+                ns / static_cast<double>(trace.size())};
+    }
+
+    void benchmark_policies() {
+        std::cout << "\n=== 淘汰策略对比 (键空间 100K, 容量 10K, 2M 次访问) ===\n";
+
+        const size_t keySpace = 100000;
+        const size_t capacity = 10000;
+        const size_t accesses = 2000000;
+
+        struct Workload {
+            const char* name;
+            std::vector<uint64_t> trace;
+        };
+        Workload workloads[] = {
+            {"Zipf(0.9)", make_zipf_trace(keySpace, accesses, 0.9)},
+            {"Zipf+扫描", make_scan_mixed_trace(keySpace, accesses, 0.9)},
+        };
+
+        for (const auto& w : workloads) {
+            std::cout << w.name << ":\n";
+            std::cout << "  策略      命中率    ns/op\n";
+            auto report = [](const char* policy, std::pair<double, double> r) {
+                std::cout << "  " << std::left << std::setw(10) << policy
+                          << std::setw(10) << std::fixed << std::setprecision(4) << r.first
+                          << std::setprecision(1) << r.second << "\n";
+            };
+            report("LRU", replay<CacheSystem::LRUPolicy>(w.trace, capacity));
+            report("CLOCK", replay<CacheSystem::ClockPolicy>(w.trace, capacity));
+            report("SLRU", replay<CacheSystem::SegmentedLRUPolicy>(w.trace, capacity));
+            report("ARC", replay<CacheSystem::ARCPolicy>(w.trace, capacity));
+        }
+    }
+
+    void benchmark_admission() {
+        std::cout << "\n=== TinyLFU 准入过滤命中率 (键空间 1M, 容量 10K, 4M 次访问) ===\n";
+        std::cout << "负载          LRU       LRU+TinyLFU  SLRU+TinyLFU\n";
+
+        const size_t keySpace = 1000000;
+        const size_t capacity = 10000;
+        const size_t accesses = 4000000;
+
+        auto row = [&](const char* name, const std::vector<uint64_t>& trace) {
+            std::cout << std::left << std::setw(14) << name << std::fixed << std::setprecision(4)
+                      << std::setw(10) << replay<CacheSystem::LRUPolicy>(trace, capacity).first
+                      << std::setw(13) << replay<CacheSystem::LRUPolicy>(trace, capacity, true).first
+                      << replay<CacheSystem::SegmentedLRUPolicy>(trace, capacity, true).first << "\n";
+        };
+        for (double skew : {0.7, 0.9, 1.1}) {
+            std::string name = "Zipf(" + std::to_string(skew).substr(0, 3) + ")";
+            row(name.c_str(), make_zipf_trace(keySpace, accesses, skew));
+        }
+        row("Zipf+扫描", make_scan_mixed_trace(keySpace, accesses, 0.9));
+    }
+
+    void benchmark_negative() {
+        std::cout << "\n=== 否定查找缓存 (容量 10K, Zipf 0.9, 一半查找的键不存在, 加载函数约 1 us) ===\n";
+        std::cout << "配置              加载次数    省下次数    误判为不存在  ns/op\n";
+
+        // 奇数键在数据源中不存在
+        const auto trace = make_zipf_trace(200000, 1000000, 0.9);
+        auto slow_loader = [](uint64_t k) -> std::optional<Payload> {
+            const auto until = Clock::now() + std::chrono::microseconds(1);
+            while (Clock::now() < until) {
+            }
+            if (k % 2 == 1) {
+                return std::nullopt;
+            }
+            return Payload("", 16);
+        };
+
+        for (bool filter : {false, true}) {
+            CacheSystem::LRUCache<uint64_t, Payload> cache(10000);
+            if (filter) {
+                cache.enable_negative_cache(20000, 0.01);
+            }
+            size_t loads = 0;
+            size_t wrong = 0;
+            auto start = Clock::now();
+            for (uint64_t k : trace) {
+                auto handle = cache.get_or_load(k, [&] {
+                    ++loads;
+                    return slow_loader(k);
+                });
+                wrong += !handle && k % 2 == 0;
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+                        / static_cast<double>(trace.size());
+
+            std::cout << std::left << (filter ? "否定查找缓存      " : "无过滤            ")
+                      << std::setw(12) << loads << std::setw(12) << cache.loader_calls_avoided()
+                      << std::setw(14) << wrong << std::fixed << std::setprecision(1) << ns << "\n";
+
+            if (filter) {
+                // 之前不存在的键被插入后，不能再被判为不存在
+                size_t stale = 0;
+                for (uint64_t k = 1; k < 2001; k += 2) {
+                    cache.put(k, Payload("", 16));
+                    cache.erase(k);
+                    stale += !cache.get_or_load(k, [] { return std::optional<Payload>(Payload("", 16)); });
+                }
+                std::cout << "插入后仍被判为不存在的键: " << stale << " / 1000\n";
+            }
+        }
+    }
+
+    // 每个线程执行固定数量的操作（每 writeEvery 个键写一次，默认 90% 读），返回总吞吐量 (Mops/s)
+    template<typename Cache>
+    double run_threads(Cache& cache, size_t threadCount, size_t opsPerThread, size_t keySpace,
+                       uint64_t writeEvery = 10) {
+        std::vector<std::vector<uint64_t>> keys(threadCount);
+        for (size_t t = 0; t < threadCount; ++t) {
+            std::mt19937_64 rng(t + 1);
+            std::uniform_int_distribution<uint64_t> dist(0, keySpace - 1);
+            keys[t].resize(opsPerThread);
+            for (auto& k : keys[t]) {
+                k = dist(rng);
+            }
+        }
+
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&cache, &go, &ks = keys[t], writeEvery] {
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (uint64_t k : ks) {
+                    if (k % writeEvery == 0 || !cache.get(k)) {
+                        cache.put(k, Payload("", 16));
+                    }
+                }
+            });
+        }
+
+        auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& w : workers) {
+            w.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return static_cast<double>(threadCount * opsPerThread) / seconds / 1e6;
+    }
+
+    void benchmark_concurrent_throughput() {
+        std::cout << "\n=== 并发吞吐量 (Mops/s, 90% 读) ===\n";
+        std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << "\n";
+        std::cout << "线程数    全局锁      分片锁(64)\n";
+
+        const size_t capacity = 100000;
+        const size_t keySpace = capacity * 2;
+        const size_t opsPerThread = 200000;
+
+        for (size_t threads : {1, 2, 4, 8, 16}) {
+            CacheSystem::ShardedLRUCache<uint64_t, Payload> global(capacity, 1);
+            CacheSystem::ShardedLRUCache<uint64_t, Payload> sharded(capacity, 64);
+
+            double globalMops = run_threads(global, threads, opsPerThread, keySpace);
+            double shardedMops = run_threads(sharded, threads, opsPerThread, keySpace);
+
+            std::cout << std::left << std::setw(10) << threads
+                      << std::setw(12) << std::fixed << std::setprecision(2) << globalMops
+                      << shardedMops << "\n";
+        }
+    }
+
+    void benchmark_read_mostly() {
+        std::cout << "\n=== 读多写少吞吐量 (Mops/s, 95% 读) ===\n";
+        std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << "\n";
+        std::cout << "线程数    分片锁(64)  无锁读\n";
+
+        const size_t capacity = 100000;
+        const size_t keySpace = capacity;  // 键空间等于容量，预热后读几乎全部命中
+        const size_t opsPerThread = 200000;
+
+        for (size_t threads : {1, 2, 4, 8, 16}) {
+            CacheSystem::ShardedLRUCache<uint64_t, Payload> sharded(capacity, 64);
+            CacheSystem::ConcurrentLRUCache<uint64_t, Payload> concurrent(capacity);
+            for (uint64_t k = 0; k < keySpace; ++k) {
+                sharded.put(k, Payload("", 16));
+                concurrent.put(k, Payload("", 16));
+            }
+
+            double shardedMops = run_threads(sharded, threads, opsPerThread, keySpace, 20);
+            double concurrentMops = run_threads(concurrent, threads, opsPerThread, keySpace, 20);
+
+            std::cout << std::left << std::setw(10) << threads
+                      << std::setw(12) << std::fixed << std::setprecision(2) << shardedMops
+                      << concurrentMops << "\n";
+        }
+    }
+
+    void benchmark_near_cache() {
+        std::cout << "\n=== 线程本地近缓存 (Mops/s, Zipf 0.99, 99% 读, 每线程 1024 槽位) ===\n";
+        std::cout << "线程数    分片锁(16)  近缓存      各线程近缓存命中率\n";
+
+        const size_t keySpace = 100000;
+        const size_t opsPerThread = 500000;
+
+        for (size_t threads : {1, 2, 4, 8}) {
+            std::vector<std::vector<uint64_t>> traces;
+            for (size_t t = 0; t < threads; ++t) {
+                traces.push_back(make_zipf_trace(keySpace, opsPerThread, 0.99));
+            }
+            CacheSystem::ShardedLRUCache<uint64_t, Payload> sharded(keySpace);
+            CacheSystem::NearCache<uint64_t, Payload> near(keySpace, 16, 1024);
+            for (uint64_t k = 0; k < keySpace; ++k) {
+                sharded.put(k, Payload("", 16));
+                near.put(k, Payload("", 16));
+            }
+
+            auto run = [&](auto&& body) {
+                std::atomic<bool> go{false};
+                std::vector<std::thread> workers;
+                for (size_t t = 0; t < threads; ++t) {
+                    workers.emplace_back([&, t] {
+                        while (!go.load(std::memory_order_acquire)) {
+                            std::this_thread::yield();
+                        }
+                        size_t sum = 0;
+                        for (size_t i = 0; i < traces[t].size(); ++i) {
+                            body(traces[t][i], i, sum);
+                        }
+                        asm volatile("" : : "r"(sum));
+                    });
+                }
+                auto start = Clock::now();
+                go.store(true, std::memory_order_release);
+                for (auto& w : workers) {
+                    w.join();
+                }
+                double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                return static_cast<double>(threads * opsPerThread) / seconds / 1e6;
+            };
+
+            double shardedMops = run([&](uint64_t k, size_t i, size_t& sum) {
+                if (i % 100 == 0) {
+                    sharded.put(k, Payload("", 16));
+                } else if (auto h = sharded.get(k)) {
+                    sum += h->data.size();
+                }
+            });
+            double nearMops = run([&](uint64_t k, size_t i, size_t& sum) {
+                if (i % 100 == 0) {
+                    near.put(k, Payload("", 16));
+                } else {
+                    near.read(k, [&](const Payload& p) { sum += p.data.size(); });
+                }
+            });
+
+            std::cout << std::left << std::setw(10) << threads
+                      << std::setw(12) << std::fixed << std::setprecision(2) << shardedMops
+                      << std::setw(12) << nearMops;
+            for (const auto& t : near.thread_stats()) {
+                if (t.hits + t.misses > 0) {
+                    std::cout << std::setprecision(3) << t.hit_rate() << " ";
+                }
+            }
+            std::cout << "\n";
+        }
+    }
+
+    void benchmark_recycle() {
+        std::cout << "\n=== 淘汰缓冲区回收 (容量 10K, 每次 put 都淘汰一个条目, ns/put) ===\n";
+        std::cout << "方式            ns/put    新分配      复用\n";
+
+        const size_t capacity = 10000;
+        const size_t totalPuts = 1000000;
+        const size_t sizes[] = {256, 1000, 1024, 3000, 4096};  // 值的元素个数
+
+        {
+            CacheSystem::LRUCache<uint64_t, Payload> cache(capacity);
+            auto start = Clock::now();
+            for (uint64_t k = 0; k < totalPuts; ++k) {
+                cache.put(k, Payload("", sizes[k % std::size(sizes)]));
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / totalPuts;
+            std::cout << std::left << std::setw(22) << "每次新分配"
+                      << std::setw(10) << std::fixed << std::setprecision(1) << ns
+                      << std::setw(12) << totalPuts << 0 << "\n";
+        }
+
+        {
+            CacheSystem::BufferPool<int, CacheSystem::detail::NullLock> pool(capacity);
+            CacheSystem::LRUCache<uint64_t, Payload> cache(capacity);
+            cache.set_eviction_listener(CacheSystem::recycle_into(pool, [](Payload&& payload) {
+                return std::move(payload.data);
+            }));
+            auto start = Clock::now();
+            for (uint64_t k = 0; k < totalPuts; ++k) {
+                size_t size = sizes[k % std::size(sizes)];
+                cache.put(k, Payload(pool.acquire(size), size));
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / totalPuts;
+            std::cout << std::left << std::setw(22) << "缓冲区池回收"
+                      << std::setw(10) << std::fixed << std::setprecision(1) << ns
+                      << std::setw(12) << pool.allocation_count() << pool.reuse_count() << "\n";
+        }
+    }
+
+    void benchmark_tiered() {
+        std::cout << "\n=== 两层缓存 (键空间 100K, 值 256 B, Zipf 0.8, 读穿) ===\n";
+        std::cout << "配置                      命中率    ns/op\n";
+
+        const size_t keySpace = 100000;
+        const size_t memoryCapacity = keySpace / 10;
+        auto trace = make_zipf_trace(keySpace, 2000000, 0.8);
+        const std::vector<int> value(64, 7);
+
+        auto run = [&](auto& cache) {
+            size_t hits = 0;
+            auto start = Clock::now();
+            for (uint64_t k : trace) {
+                if (cache.get(k)) {
+                    ++hits;
+                } else {
+                    cache.put(k, value);  // 未命中时重建并回填
+                }
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+                        / static_cast<double>(trace.size());
+            return std::make_pair(static_cast<double>(hits) / static_cast<double>(trace.size()), ns);
+        };
+        auto print = [](const char* name, std::pair<double, double> result) {
+            std::cout << std::left << name << std::fixed << std::setprecision(3) << std::setw(10)
+                      << result.first << std::setprecision(1) << result.second << "\n";
+        };
+
+        {
+            CacheSystem::LRUCache<uint64_t, std::vector<int>> cache(memoryCapacity);
+            print("内存 10K                  ", run(cache));
+        }
+        {
+            auto path = (std::filesystem::temp_directory_path() / "cache_benchmark.spill").string();
+            CacheSystem::TieredCache<uint64_t, std::vector<int>> cache(memoryCapacity, path, 64 << 20);
+            print("内存 10K + 溢出文件 64 MB ", run(cache));
+        }
+        {
+            CacheSystem::LRUCache<uint64_t, std::vector<int>> cache(keySpace);
+            print("内存 100K                 ", run(cache));
+        }
+    }
+
+    void benchmark_compress() {
+        std::cout << "\n=== 整数序列编码 (每个序列 4096 个 int) ===\n";
+        std::cout << "序列            编码         压缩比    解码 GB/s\n";
+
+        const size_t length = 4096;
+        std::mt19937_64 rng(42);
+        std::vector<std::pair<const char*, std::vector<int>>> inputs;
+        {
+            std::vector<int> v(length);
+            std::iota(v.begin(), v.end(), 0);
+            inputs.emplace_back("iota            ", std::move(v));
+        }
+        {
+            std::vector<int> v(length);
+            int x = 0;
+            for (int& e : v) {
+                x += static_cast<int>(rng() % 40);
+                e = x;
+            }
+            inputs.emplace_back("有序, 间隔 0~39 ", std::move(v));
+        }
+        {
+            std::vector<int> v;
+            while (v.size() < length) {
+                v.insert(v.end(), std::min<size_t>(1 + rng() % 64, length - v.size()), static_cast<int>(rng() % 1000));
+            }
+            inputs.emplace_back("游程, 长 1~64   ", std::move(v));
+        }
+
+        static const char* const kNames[] = {"raw", "delta+varint", "delta runs"};
+        for (auto& [name, values] : inputs) {
+            auto packed = CacheSystem::PackedSequence<int>::encode(values);
+            std::vector<int> out;
+            const size_t rounds = 20000;
+            auto start = Clock::now();
+            for (size_t r = 0; r < rounds; ++r) {
+                packed.decode_into(out);
+                asm volatile("" : : "r"(out.data()) : "memory");
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (out != values) {
+                std::cout << "解码结果不一致!\n";
+            }
+            std::cout << name << std::left << std::setw(13) << kNames[static_cast<int>(packed.encoding())]
+                      << std::fixed << std::setprecision(1) << std::setw(10)
+                      << static_cast<double>(packed.raw_bytes()) / static_cast<double>(packed.encoded_bytes())
+                      << static_cast<double>(packed.raw_bytes() * rounds) / seconds / 1e9 << "\n";
+        }
+
+        std::cout << "\n=== 相同内存预算 (约 16 MB) 下的命中率 (键空间 20K, 值为 1024 个有序 int, Zipf 0.8) ===\n";
+        std::cout << "配置                          命中率    ns/op     解码次数\n";
+        const size_t keySpace = 20000;
+        const size_t budget = 16 << 20;
+        auto trace = make_zipf_trace(keySpace, 1000000, 0.8);
+        auto make_value = [](uint64_t key) {
+            std::vector<int> v(1024);
+            int x = static_cast<int>(key);
+            for (size_t i = 0; i < v.size(); ++i) {
+                x += static_cast<int>((key + i * 7) % 13);
+                v[i] = x;
+            }
+            return v;
+        };
+        auto run = [&](const char* name, auto& cache, auto decodes) {
+            size_t hits = 0;
+            auto start = Clock::now();
+            for (uint64_t k : trace) {
+                if (cache.get(k)) {
+                    ++hits;
+                } else {
+                    cache.put(k, make_value(k));  // 未命中时重建并回填
+                }
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+                        / static_cast<double>(trace.size());
+            std::cout << std::left << name << std::fixed << std::setprecision(3) << std::setw(10)
+                      << static_cast<double>(hits) / static_cast<double>(trace.size())
+                      << std::setprecision(1) << std::setw(10) << ns << decodes(cache) << "\n";
+        };
+
+        const size_t valueBytes = 1024 * sizeof(int);
+        {
+            CacheSystem::LRUCache<uint64_t, std::vector<int>> cache(budget / valueBytes);
+            run("不压缩 (4096 条目)            ", cache, [](auto&) { return 0; });
+        }
+        for (size_t hotShare : {50, 25, 10}) {
+            const size_t hotBytes = budget * hotShare / 100;
+            CacheSystem::CompressedCache<uint64_t, int> cache(hotBytes / valueBytes, budget - hotBytes);
+            std::string name = "压缩冷段, 热段占 " + std::to_string(hotShare) + "%          ";
+            run(name.c_str(), cache, [](auto& c) { return c.decode_count(); });
+        }
+    }
+
+    void benchmark_stats() {
+        std::cout << "\n=== 统计开销 (ns/次) ===\n";
+        const size_t iterations = 10000000;
+
+        CacheSystem::StatsRecorder recorder;
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            recorder.add(CacheSystem::StatsRecorder::kHits);
+        }
+        double addNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+
+        start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            CacheSystem::StatsRecorder::Timer timer(recorder, CacheSystem::StatsRecorder::kGet);
+        }
+        double timerNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+        std::cout << "计数器加一: " << std::fixed << std::setprecision(2) << addNs
+                  << "   采样计时 (1/64): " << timerNs << "\n";
+
+        const size_t capacity = 100000;
+        auto keys = make_keys(capacity, 2000000);
+        CacheSystem::LRUCache<uint64_t, Payload> cache(capacity);
+        size_t hits = 0;
+        run_mixed(cache, keys, hits);
+        CacheSystem::CacheStats stats = cache.stats();
+        std::cout << "命中 " << stats.hits << "  未命中 " << stats.misses << "  插入 " << stats.inserts
+                  << "  更新 " << stats.updates << "  淘汰 " << stats.evictions << "\n";
+        std::cout << "get 延迟 p50/p99 (ns): " << stats.getLatency.percentile(0.5) << " / "
+                  << stats.getLatency.percentile(0.99) << "   put 延迟 p50/p99 (ns): "
+                  << stats.putLatency.percentile(0.5) << " / " << stats.putLatency.percentile(0.99) << "\n";
+    }
+
+    void benchmark_batch() {
+        std::cout << "\n=== 批量操作 (分片 16, 容量 100K, ns/键) ===\n";
+        std::cout << "批大小      multi_get   multi_put\n";
+
+        using Cache = CacheSystem::ShardedLRUCache<uint64_t, uint64_t>;
+        const size_t capacity = 100000;
+        const size_t totalKeys = 2000000;
+        // 键空间略大于容量：读约 80% 命中，写约 80% 是更新
+        auto keys = make_keys(capacity * 5 / 8, totalKeys);
+
+        auto perKey = [&](Clock::time_point start) {
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+                   / static_cast<double>(totalKeys);
+        };
+        auto prefill = [&](Cache& cache) {
+            std::vector<std::pair<uint64_t, uint64_t>> items;
+            for (uint64_t k = 0; k < capacity; ++k) {
+                items.emplace_back(k, k);
+            }
+            cache.multi_put(items);
+        };
+
+        {
+            Cache cache(capacity);
+            prefill(cache);
+            auto start = Clock::now();
+            size_t hits = 0;
+            for (uint64_t k : keys) {
+                hits += static_cast<bool>(cache.get(k));
+            }
+            double getNs = perKey(start);
+
+            start = Clock::now();
+            for (uint64_t k : keys) {
+                cache.put(k, k);
+            }
+            double putNs = perKey(start);
+            std::cout << std::left << std::setw(12) << "逐个" << "  "
+                      << std::setw(12) << std::fixed << std::setprecision(1) << getNs << putNs
+                      << "  (命中 " << hits << ")\n";
+        }
+
+        for (size_t batch : {1, 8, 32, 64, 128, 200}) {
+            Cache cache(capacity);
+            prefill(cache);
+            std::vector<Cache::Handle> out(batch);
+            std::span<const uint64_t> all(keys);
+
+            auto start = Clock::now();
+            for (size_t i = 0; i < totalKeys; i += batch) {
+                auto chunk = all.subspan(i, std::min(batch, totalKeys - i));
+                cache.multi_get(chunk, out);
+            }
+            cache.release_batch(out);
+            double getNs = perKey(start);
+
+            std::vector<std::pair<uint64_t, uint64_t>> items(batch);
+            start = Clock::now();
+            for (size_t i = 0; i < totalKeys; i += batch) {
+                size_t n = std::min(batch, totalKeys - i);
+                for (size_t j = 0; j < n; ++j) {
+                    items[j] = {keys[i + j], keys[i + j]};
+                }
+                cache.multi_put(std::span(items.data(), n));
+            }
+            double putNs = perKey(start);
+
+            std::cout << std::left << std::setw(12) << batch
+                      << std::setw(12) << std::fixed << std::setprecision(1) << getNs << putNs << "\n";
+        }
+
+        // 一批中重复出现的键共用一个节点：条目已过期时只能摘下一次，其余出现按未命中处理
+        {
+            Cache cache(capacity);
+            for (uint64_t k = 0; k < 64; ++k) {
+                cache.put(k, k, std::chrono::milliseconds(1));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            std::vector<uint64_t> duplicated;
+            for (uint64_t k = 0; k < 64; ++k) {
+                duplicated.insert(duplicated.end(), {k, k, k});
+            }
+            std::vector<Cache::Handle> out(duplicated.size());
+            const size_t hits = cache.multi_get(duplicated, out);
+            cache.release_batch(out);
+            std::cout << "重复键 + 已过期: 命中 " << hits << "  剩余条目 " << cache.size() << "\n";
+        }
+    }
+
+    void benchmark_index() {
+        std::cout << "\n=== 键索引对比 (1M 键, ns/op) ===\n";
+        std::cout << "索引              插入      命中查找  未命中查找  索引内存(MB)\n";
+
+        struct Node {
+            size_t hash;
+            uint64_t key;
+            uint64_t value;
+        };
+
+        const size_t keyCount = 1000000;
+        const size_t lookups = 10000000;
+        std::mt19937_64 rng(99);
+        std::vector<Node> nodes(keyCount);
+        for (auto& node : nodes) {
+            node.key = rng();
+            node.hash = std::hash<uint64_t>{}(node.key);
+            node.value = node.key;
+        }
+        std::vector<uint64_t> hitKeys(lookups);
+        std::vector<uint64_t> missKeys(lookups);
+        for (size_t i = 0; i < lookups; ++i) {
+            hitKeys[i] = nodes[rng() % keyCount].key;
+            missKeys[i] = rng();
+        }
+
+        auto nsPerOp = [](Clock::time_point start, size_t ops) {
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+                   / static_cast<double>(ops);
+        };
+        auto report = [](const char* name, double insertNs, double hitNs, double missNs, size_t bytes) {
+            std::cout << std::left << std::setw(18) << name << std::fixed << std::setprecision(1)
+                      << std::setw(10) << insertNs << std::setw(10) << hitNs << std::setw(12) << missNs
+                      << static_cast<double>(bytes) / (1 << 20) << "\n";
+        };
+
+        uint64_t checksum = 0;
+        {
+            CacheSystem::SwissIndex<Node> index;
+            auto start = Clock::now();
+            for (auto& node : nodes) {
+                index.insert(&node);
+            }
+            double insertNs = nsPerOp(start, keyCount);
+
+            auto lookup = [&](const std::vector<uint64_t>& keys) {
+                auto begin = Clock::now();
+                for (uint64_t key : keys) {
+                    size_t hash = std::hash<uint64_t>{}(key);
+                    const Node* node = index.find(hash, [&](const Node* n) { return n->key == key; });
+                    checksum += node ? node->value : 1;
+                }
+                return nsPerOp(begin, keys.size());
+            };
+            double hitNs = lookup(hitKeys);
+            double missNs = lookup(missKeys);
+            report("SwissIndex", insertNs, hitNs, missNs, index.memory_usage());
+        }
+        {
+            std::unordered_map<uint64_t, Node*> index;
+            auto start = Clock::now();
+            for (auto& node : nodes) {
+                index.emplace(node.key, &node);
+            }
+            double insertNs = nsPerOp(start, keyCount);
+
+            auto lookup = [&](const std::vector<uint64_t>& keys) {
+                auto begin = Clock::now();
+                for (uint64_t key : keys) {
+                    auto it = index.find(key);
+                    checksum += it != index.end() ? it->second->value : 1;
+                }
+                return nsPerOp(begin, keys.size());
+            };
+            double hitNs = lookup(hitKeys);
+            double missNs = lookup(missKeys);
+            // 每个元素一个链表节点（键 + 指针 + next + 缓存的哈希）外加桶数组
+            size_t bytes = index.size() * (sizeof(std::pair<const uint64_t, Node*>) + 2 * sizeof(void*))
+                           + index.bucket_count() * sizeof(void*);
+            report("unordered_map", insertNs, hitNs, missNs, bytes);
+        }
+        std::cout << "(校验和 " << checksum % 1000 << ")\n";
+    }
+
+    bool selected(int argc, char** argv, const char* name) {
+        return argc < 2 || std::strcmp(argv[1], name) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "缓存性能基准测试\n";
+    std::cout << "================\n";
+
+    if (selected(argc, argv, "lru")) {
+        benchmark_lru_capacity_sweep();
+    }
+    if (selected(argc, argv, "concurrent")) {
+        benchmark_concurrent_throughput();
+    }
+    if (selected(argc, argv, "policy")) {
+        benchmark_policies();
+    }
+    if (selected(argc, argv, "admission")) {
+        benchmark_admission();
+    }
+    if (selected(argc, argv, "batch")) {
+        benchmark_batch();
+    }
+    if (selected(argc, argv, "negative")) {
+        benchmark_negative();
+    }
+    if (selected(argc, argv, "index")) {
+        benchmark_index();
+    }
+    if (selected(argc, argv, "readmostly")) {
+        benchmark_read_mostly();
+    }
+    if (selected(argc, argv, "near")) {
+        benchmark_near_cache();
+    }
+    if (selected(argc, argv, "recycle")) {
+        benchmark_recycle();
+    }
+    if (selected(argc, argv, "stats")) {
+        benchmark_stats();
+    }
+    if (selected(argc, argv, "tiered")) {
+        benchmark_tiered();
+    }
+    if (selected(argc, argv, "compress")) {
+        benchmark_compress();
+    }
+
+    return 0;
+}
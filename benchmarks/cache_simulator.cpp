@@ -0,0 +1,590 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+
+#include "cache_system/lru_cache.hpp"
+
+/**
+ * 基于访问 trace 的缓存模拟器 - 离线选择缓存容量与淘汰策略
+ *
+ * 用法: cache_simulator [选项]
+ *   --trace FILE         回放 trace 文件：文本格式每行 "键" 或 "键 大小"，
+ *                        以 .bin 结尾时为二进制记录（uint64 键 + uint32 大小，本机字节序）
+ *   --workload NAME      没有 --trace 时生成合成 trace：zipf | scan | temporal（默认 zipf）
+ *   --accesses N         合成 trace 的访问次数（默认 10000000）
+ *   --keys N             合成 trace 的键空间（默认 1000000）
+ *   --skew S             Zipf 偏斜度（默认 0.99）
+ *   --capacity LIST      逗号分隔的容量（默认键空间的 1%,5%,10%）
+ *   --policy LIST        逗号分隔的策略：lru,clock,slru,arc（默认全部）
+ *   --admission          额外模拟启用 TinyLFU 准入过滤的配置
+ *   --bytes              容量按对象大小（字节）计量，默认按条目数
+ *   --write-trace FILE   把合成 trace 写成二进制文件后退出
+ *
+ * trace 按块读入或生成，每块依次回放给所有配置，trace 本身不需要整体放进内存；
+ * 每个配置以读穿方式回放（未命中时回填），只统计缓存操作本身的耗时。
+ * 报告命中率、字节命中率、回源字节数（未命中对象的大小之和）与 ns/op。
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Access {
+        uint64_t key;
+        uint32_t size;
+    };
+
+    constexpr size_t kChunkSize = 1 << 20;
+    constexpr size_t kRecordSize = sizeof(uint64_t) + sizeof(uint32_t);
+
+    // 合成 trace 中对象的大小：按键确定，128 B 到 16 KB 之间按 2 的幂均匀分布
+    constexpr uint64_t kMeanObjectSize = 4080;
+
+    uint32_t object_size(uint64_t key) noexcept {
+        return 128u << ((key * 0x9e3779b97f4a7c15ULL) >> 61);
+    }
+
+    // Zipf 分布采样（拒绝-反演法，Hörmann & Derflinger），不需要按键空间建表，
+    // 每次采样 O(1)，可以用于上亿的键空间；返回 [0, n)
+    class ZipfSampler {
+    private:
+        double skew;
+        double hIntegralX1;
+        double hIntegralN;
+        double s;
+        uint64_t n;
+        std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+        // log(1 + x) / x，x 接近 0 时用泰勒展开
+        static double helper1(double x) noexcept {
+            return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+        }
+
+        // (exp(x) - 1) / x
+        static double helper2(double x) noexcept {
+            return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+        }
+
+        double h(double x) const noexcept { return std::exp(-skew * std::log(x)); }
+
+        double h_integral(double x) const noexcept {
+            const double logX = std::log(x);
+            return helper2((1.0 - skew) * logX) * logX;
+        }
+
+        double h_integral_inverse(double x) const noexcept {
+            double t = x * (1.0 - skew);
+            if (t < -1.0) {
+                t = -1.0;
+            }
+            return std::exp(helper1(t) * x);
+        }
+
+    public:
+        ZipfSampler(uint64_t keys, double exponent)
+            : skew(exponent),
+              hIntegralX1(0.0),
+              hIntegralN(0.0),
+              s(0.0),
+              n(keys) {
+            hIntegralX1 = h_integral(1.5) - 1.0;
+            hIntegralN = h_integral(static_cast<double>(n) + 0.5);
+            s = 2.0 - h_integral_inverse(h_integral(2.5) - h(2.0));
+        }
+
+        template<typename Rng>
+        uint64_t operator()(Rng& rng) {
+            for (;;) {
+                const double u = hIntegralN + uniform(rng) * (hIntegralX1 - hIntegralN);
+                const double x = h_integral_inverse(u);
+                auto k = static_cast<uint64_t>(x + 0.5);
+                k = std::clamp<uint64_t>(k, 1, n);
+                const double kd = static_cast<double>(k);
+                if (kd - x <= s || u >= h_integral(kd + 0.5) - h(kd)) {
+                    return k - 1;
+                }
+            }
+        }
+    };
+
+    // trace 来源：按块产出访问记录，返回 0 表示结束
+    class TraceSource {
+    public:
+        virtual ~TraceSource() = default;
+        virtual size_t fill(std::vector<Access>& chunk) = 0;
+        virtual std::string describe() const = 0;
+    };
+
+    // 合成 trace 的公共部分：固定种子，按总访问次数截止
+    class SyntheticTrace : public TraceSource {
+    protected:
+        std::mt19937_64 rng{42};
+        uint64_t remaining;
+        uint64_t keySpace;
+
+        virtual uint64_t next_key() = 0;
+
+    public:
+        SyntheticTrace(uint64_t accesses, uint64_t keys) : remaining(accesses), keySpace(keys) {}
+
+        size_t fill(std::vector<Access>& chunk) override {
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(remaining, kChunkSize));
+            chunk.resize(count);
+            for (auto& access : chunk) {
+                access.key = next_key();
+                access.size = object_size(access.key);
+            }
+            remaining -= count;
+            return count;
+        }
+    };
+
+    // 纯 Zipf 热点访问
+    class ZipfTrace : public SyntheticTrace {
+    private:
+        ZipfSampler zipf;
+        double skew;
+
+        uint64_t next_key() override { return zipf(rng); }
+
+    public:
+        ZipfTrace(uint64_t accesses, uint64_t keys, double s)
+            : SyntheticTrace(accesses, keys), zipf(keys, s), skew(s) {}
+
+        std::string describe() const override {
+            return "Zipf (键空间 " + std::to_string(keySpace) + ", 偏斜度 " + std::to_string(skew) + ")";
+        }
+    };
+
+    // Zipf 热点访问中周期性插入只访问一次的顺序扫描（每 5000 次热点访问后扫描 2000 个新键）
+    class ScanMixedTrace : public SyntheticTrace {
+    private:
+        ZipfSampler zipf;
+        uint64_t scanKey;
+        uint64_t position = 0;
+
+        uint64_t next_key() override {
+            return position++ % 7000 < 5000 ? zipf(rng) : scanKey++;
+        }
+
+    public:
+        ScanMixedTrace(uint64_t accesses, uint64_t keys, double s)
+            : SyntheticTrace(accesses, keys), zipf(keys, s), scanKey(keys) {}
+
+        std::string describe() const override {
+            return "Zipf + 扫描 (键空间 " + std::to_string(keySpace) + ")";
+        }
+    };
+
+    // 时间局部性：70% 的访问重复最近访问过的键（距离服从均值 100 的几何分布），
+    // 其余访问均匀地落在整个键空间
+    class TemporalTrace : public SyntheticTrace {
+    private:
+        static constexpr size_t kHistory = 1 << 16;
+
+        std::vector<uint64_t> history = std::vector<uint64_t>(kHistory);
+        uint64_t position = 0;
+        std::bernoulli_distribution reuse{0.7};
+        std::geometric_distribution<uint64_t> distance{0.01};
+        std::uniform_int_distribution<uint64_t> uniform;
+
+        uint64_t next_key() override {
+            uint64_t key;
+            uint64_t back = distance(rng) + 1;
+            if (back <= position && back < kHistory && reuse(rng)) {
+                key = history[(position - back) % kHistory];
+            } else {
+                key = uniform(rng);
+            }
+            history[position++ % kHistory] = key;
+            return key;
+        }
+
+    public:
+        TemporalTrace(uint64_t accesses, uint64_t keys)
+            : SyntheticTrace(accesses, keys), uniform(0, keys - 1) {}
+
+        std::string describe() const override {
+            return "时间局部性 (键空间 " + std::to_string(keySpace) + ", 70% 近期重复)";
+        }
+    };
+
+    // 从文件流式读取 trace
+    class FileTrace : public TraceSource {
+    private:
+        std::string path;
+        std::FILE* file;
+        bool binary;
+        std::vector<char> buffer = std::vector<char>(1 << 22);
+        size_t begin = 0;
+        size_t end = 0;
+        bool eof = false;
+
+        // 保留未处理完的尾部，再读入一段
+        bool refill() {
+            if (eof) {
+                return false;
+            }
+            std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+            size_t got = std::fread(buffer.data() + end, 1, buffer.size() - end, file);
+            if (got == 0) {
+                eof = true;
+                return false;
+            }
+            end += got;
+            return true;
+        }
+
+        bool next_binary(Access& access) {
+            if (end - begin < kRecordSize && !refill() && end - begin < kRecordSize) {
+                if (end != begin) {
+                    throw std::runtime_error("trace 文件末尾有不完整的记录: " + path);
+                }
+                return false;
+            }
+            std::memcpy(&access.key, buffer.data() + begin, sizeof(uint64_t));
+            std::memcpy(&access.size, buffer.data() + begin + sizeof(uint64_t), sizeof(uint32_t));
+            begin += kRecordSize;
+            return true;
+        }
+
+        bool next_text(Access& access) {
+            for (;;) {
+                const char* newline = static_cast<const char*>(
+                    std::memchr(buffer.data() + begin, '\n', end - begin));
+                if (!newline && refill()) {
+                    continue;
+                }
+                // refill 会把未处理的部分移到缓冲区开头，位置在它之后再计算
+                const char* first = buffer.data() + begin;
+                const char* last = buffer.data() + end;
+                if (!newline) {
+                    if (first == last) {
+                        return false;
+                    }
+                    newline = last;  // 最后一行没有换行符
+                }
+                begin = static_cast<size_t>(newline - buffer.data()) + (newline != last ? 1 : 0);
+                while (first < newline && (*first == ' ' || *first == '\t')) {
+                    ++first;
+                }
+                if (first == newline || *first == '#' || *first == '\r') {
+                    continue;  // 空行或注释
+                }
+                auto [p, ec] = std::from_chars(first, newline, access.key);
+                if (ec != std::errc()) {
+                    throw std::runtime_error("无法解析 trace 行: " + std::string(first, newline));
+                }
+                while (p < newline && (*p == ' ' || *p == '\t' || *p == ',')) {
+                    ++p;
+                }
+                access.size = 1;
+                if (p < newline && *p != '\r') {
+                    std::from_chars(p, newline, access.size);
+                }
+                return true;
+            }
+        }
+
+    public:
+        explicit FileTrace(std::string filePath)
+            : path(std::move(filePath)), file(std::fopen(path.c_str(), "rb")),
+              binary(path.ends_with(".bin")) {
+            if (!file) {
+                throw std::runtime_error("无法打开 trace 文件: " + path);
+            }
+        }
+
+        ~FileTrace() override { std::fclose(file); }
+
+        size_t fill(std::vector<Access>& chunk) override {
+            chunk.resize(kChunkSize);
+            size_t count = 0;
+            while (count < kChunkSize && (binary ? next_binary(chunk[count]) : next_text(chunk[count]))) {
+                ++count;
+            }
+            chunk.resize(count);
+            return count;
+        }
+
+        std::string describe() const override { return "trace 文件 " + path; }
+    };
+
+    // 一个 (策略, 容量, 准入过滤) 配置的回放状态
+    class Simulation {
+    public:
+        std::string policy;
+        size_t capacity;
+        bool admission;
+        uint64_t hits = 0;
+        uint64_t accesses = 0;
+        uint64_t bytesHit = 0;
+        uint64_t bytesMoved = 0;  // 未命中时回源的字节数
+        double seconds = 0.0;
+
+        Simulation(std::string p, size_t c, bool a) : policy(std::move(p)), capacity(c), admission(a) {}
+        virtual ~Simulation() = default;
+
+        virtual void replay(std::span<const Access> chunk) = 0;
+    };
+
+    template<template<typename> class Policy>
+    class PolicySimulation : public Simulation {
+    private:
+        using Cache = CacheSystem::LRUCache<uint64_t, uint32_t, Policy>;
+
+        Cache cache;
+
+        // 按字节计量时值就是对象大小；Weigher 为空时每个条目权重为 1
+        static typename Cache::Weigher weigher(bool bytes) {
+            if (!bytes) {
+                return {};
+            }
+            return [](const uint64_t&, const uint32_t& size) { return static_cast<size_t>(size); };
+        }
+
+    public:
+        PolicySimulation(std::string name, size_t capacity, bool admission, bool bytes)
+            : Simulation(std::move(name), capacity, admission), cache(capacity, weigher(bytes)) {
+            if (admission) {
+                cache.enable_admission_filter(bytes ? capacity / kMeanObjectSize + 1 : 0);
+            }
+        }
+
+        void replay(std::span<const Access> chunk) override {
+            uint64_t chunkHits = 0;
+            uint64_t chunkBytesHit = 0;
+            uint64_t chunkBytesMoved = 0;
+            auto start = Clock::now();
+            for (const Access& access : chunk) {
+                if (cache.get(access.key)) {
+                    ++chunkHits;
+                    chunkBytesHit += access.size;
+                } else {
+                    chunkBytesMoved += access.size;
+                    cache.put(access.key, access.size);
+                }
+            }
+            seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            hits += chunkHits;
+            accesses += chunk.size();
+            bytesHit += chunkBytesHit;
+            bytesMoved += chunkBytesMoved;
+        }
+    };
+
+    struct Options {
+        std::string trace;
+        std::string workload = "zipf";
+        std::string writeTrace;
+        uint64_t accesses = 10000000;
+        uint64_t keys = 1000000;
+        double skew = 0.99;
+        std::vector<size_t> capacities;
+        std::vector<std::string> policies = {"lru", "clock", "slru", "arc"};
+        bool admission = false;
+        bool bytes = false;
+    };
+
+    std::vector<std::string> split(std::string_view list) {
+        std::vector<std::string> items;
+        while (!list.empty()) {
+            size_t comma = list.find(',');
+            items.emplace_back(list.substr(0, comma));
+            list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        }
+        return items;
+    }
+
+    uint64_t parse_number(std::string_view text) {
+        uint64_t value = 0;
+        auto [p, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || p != text.data() + text.size()) {
+            throw std::invalid_argument("无效的数字: " + std::string(text));
+        }
+        return value;
+    }
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto value = [&]() -> std::string_view {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("缺少参数值: " + std::string(arg));
+                }
+                return argv[++i];
+            };
+            if (arg == "--trace") {
+                options.trace = value();
+            } else if (arg == "--workload") {
+                options.workload = value();
+            } else if (arg == "--accesses") {
+                options.accesses = parse_number(value());
+            } else if (arg == "--keys") {
+                options.keys = std::max<uint64_t>(parse_number(value()), 1);
+            } else if (arg == "--skew") {
+                options.skew = std::stod(std::string(value()));
+            } else if (arg == "--capacity") {
+                for (const auto& item : split(value())) {
+                    options.capacities.push_back(parse_number(item));
+                }
+            } else if (arg == "--policy") {
+                options.policies = split(value());
+            } else if (arg == "--admission") {
+                options.admission = true;
+            } else if (arg == "--bytes") {
+                options.bytes = true;
+            } else if (arg == "--write-trace") {
+                options.writeTrace = value();
+            } else {
+                throw std::invalid_argument("未知选项: " + std::string(arg));
+            }
+        }
+        if (options.capacities.empty()) {
+            // 默认为键空间的 1%、5%、10%；按字节计量时乘以合成对象的平均大小
+            const uint64_t unit = options.bytes ? kMeanObjectSize : 1;
+            for (uint64_t percent : {1, 5, 10}) {
+                options.capacities.push_back(std::max<uint64_t>(options.keys * percent / 100, 1) * unit);
+            }
+        }
+        return options;
+    }
+
+    std::unique_ptr<TraceSource> make_source(const Options& options) {
+        if (!options.trace.empty()) {
+            return std::make_unique<FileTrace>(options.trace);
+        }
+        if (options.workload == "zipf") {
+            return std::make_unique<ZipfTrace>(options.accesses, options.keys, options.skew);
+        }
+        if (options.workload == "scan") {
+            return std::make_unique<ScanMixedTrace>(options.accesses, options.keys, options.skew);
+        }
+        if (options.workload == "temporal") {
+            return std::make_unique<TemporalTrace>(options.accesses, options.keys);
+        }
+        throw std::invalid_argument("未知的负载类型: " + options.workload);
+    }
+
+    std::unique_ptr<Simulation> make_simulation(const std::string& policy, size_t capacity,
+                                                bool admission, bool bytes) {
+        if (policy == "lru") {
+            return std::make_unique<PolicySimulation<CacheSystem::LRUPolicy>>(policy, capacity, admission, bytes);
+        }
+        if (policy == "clock") {
+            return std::make_unique<PolicySimulation<CacheSystem::ClockPolicy>>(policy, capacity, admission, bytes);
+        }
+        if (policy == "slru") {
+            return std::make_unique<PolicySimulation<CacheSystem::SegmentedLRUPolicy>>(policy, capacity, admission, bytes);
+        }
+        if (policy == "arc") {
+            return std::make_unique<PolicySimulation<CacheSystem::ARCPolicy>>(policy, capacity, admission, bytes);
+        }
+        throw std::invalid_argument("未知的策略: " + policy);
+    }
+
+    // 把合成 trace 写成二进制记录
+    void write_trace(TraceSource& source, const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("无法创建 trace 文件: " + path);
+        }
+        std::vector<Access> chunk;
+        std::vector<char> records;
+        uint64_t total = 0;
+        while (source.fill(chunk) != 0) {
+            records.resize(chunk.size() * kRecordSize);
+            char* out = records.data();
+            for (const Access& access : chunk) {
+                std::memcpy(out, &access.key, sizeof(uint64_t));
+                std::memcpy(out + sizeof(uint64_t), &access.size, sizeof(uint32_t));
+                out += kRecordSize;
+            }
+            if (std::fwrite(records.data(), 1, records.size(), file) != records.size()) {
+                std::fclose(file);
+                throw std::runtime_error("写入 trace 文件失败: " + path);
+            }
+            total += chunk.size();
+        }
+        std::fclose(file);
+        std::cout << "已写入 " << total << " 条访问记录 -> " << path << "\n";
+    }
+
+    void report(const std::vector<std::unique_ptr<Simulation>>& simulations, bool bytes) {
+        std::cout << "策略    " << (bytes ? "容量(字节)    " : "容量          ")
+                  << "准入  命中率    字节命中率  回源 MB       ns/op\n";
+        for (const auto& sim : simulations) {
+            const double accesses = static_cast<double>(std::max<uint64_t>(sim->accesses, 1));
+            const double totalBytes = static_cast<double>(std::max<uint64_t>(sim->bytesHit + sim->bytesMoved, 1));
+            std::cout << std::left << std::setw(8) << sim->policy << std::setw(14) << sim->capacity
+                      << (sim->admission ? "是    " : "否    ")
+                      << std::fixed << std::setprecision(4)
+                      << std::setw(10) << static_cast<double>(sim->hits) / accesses
+                      << std::setw(12) << static_cast<double>(sim->bytesHit) / totalBytes
+                      << std::setprecision(1)
+                      << std::setw(14) << static_cast<double>(sim->bytesMoved) / (1024.0 * 1024.0)
+                      << sim->seconds * 1e9 / accesses << "\n";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        Options options = parse_options(argc, argv);
+        auto source = make_source(options);
+        if (!options.writeTrace.empty()) {
+            write_trace(*source, options.writeTrace);
+            return 0;
+        }
+
+        std::vector<std::unique_ptr<Simulation>> simulations;
+        for (const auto& policy : options.policies) {
+            for (size_t capacity : options.capacities) {
+                simulations.push_back(make_simulation(policy, capacity, false, options.bytes));
+                if (options.admission) {
+                    simulations.push_back(make_simulation(policy, capacity, true, options.bytes));
+                }
+            }
+        }
+
+        std::cout << "缓存模拟器: " << source->describe() << "\n";
+        std::cout << "配置数: " << simulations.size() << "\n\n";
+
+        auto start = Clock::now();
+        std::vector<Access> chunk;
+        uint64_t total = 0;
+        while (source->fill(chunk) != 0) {
+            for (auto& sim : simulations) {
+                sim->replay(chunk);
+            }
+            total += chunk.size();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        report(simulations, options.bytes);
+        std::cout << "\n访问次数: " << total << ", 总耗时: " << std::setprecision(2) << seconds << " s\n";
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << "\n";
+        std::cerr << "用法: cache_simulator [--trace FILE | --workload zipf|scan|temporal] [--accesses N] "
+                     "[--keys N] [--skew S] [--capacity A,B,...] [--policy lru,clock,slru,arc] "
+                     "[--admission] [--bytes] [--write-trace FILE]\n";
+        return 1;
+    }
+    return 0;
+}
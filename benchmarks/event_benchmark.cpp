@@ -0,0 +1,425 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <queue>
+#include <tuple>
+#include <algorithm>
+#include <cstddef>
+
+#include "event_system/event_handler.hpp"
+#include "event_system/variant_event_handler.hpp"
+
+/**
+ * 事件系统性能基准测试
+ *
+ * 用法: event_benchmark [section]
+ *   dispatch   - 2 / 16 / 64 种事件类型轮流出现时，按类型编号查表分派与旧的 dynamic_cast 链的每事件耗时
+ *   inline     - 每轮加入 1000 个事件再全部处理：unique_ptr 队列与 variant 环形缓冲区的吞吐量和每事件堆分配次数
+ *   producers  - 1 / 2 / 4 / 8 个生产者线程同时加入事件、一个消费者线程处理：MPSC 队列与互斥锁 + std::queue 的吞吐量
+ *   budget     - 突发 100K 个事件：一次全部处理与每次限量 / 限时处理时单次调用的最长耗时和总吞吐量
+ *   header     - 事件头：每个事件保存 std::string 类型名（旧）与 2 字节类型编号的对象大小和创建 + 销毁耗时
+ *
+ * 不带参数时运行全部测试。
+ */
+
+// 统计堆分配次数（inline 测试报告每个事件的分配数）
+// GCC 会把内联后的 new 与替换后的 delete 误判为不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+namespace {
+    std::atomic<size_t> allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    template<size_t N>
+    class BenchEvent : public EventSystem::EventOf<BenchEvent<N>> {
+    private:
+        int value;
+
+    public:
+        explicit BenchEvent(int v) : value(v) {}
+
+        int getValue() const { return value; }
+    };
+
+    template<size_t... I>
+    std::vector<std::unique_ptr<EventSystem::Event>> make_events(size_t count, std::index_sequence<I...>) {
+        using Factory = std::unique_ptr<EventSystem::Event> (*)(int);
+        static constexpr Factory kFactories[] = {
+            [](int v) -> std::unique_ptr<EventSystem::Event> { return std::make_unique<BenchEvent<I>>(v); }...};
+        std::vector<std::unique_ptr<EventSystem::Event>> events;
+        events.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            events.push_back(kFactories[i % sizeof...(I)](static_cast<int>(i)));
+        }
+        return events;
+    }
+
+    // 旧实现：依次尝试 dynamic_cast 到每一种事件类型，仅作为对照组
+    template<size_t... I>
+    bool dispatch_by_cast(EventSystem::Event& event, int64_t& sum, std::index_sequence<I...>) {
+        return ((dynamic_cast<BenchEvent<I>*>(&event) ? (sum += dynamic_cast<BenchEvent<I>*>(&event)->getValue(), true)
+                                                      : false) || ...);
+    }
+
+    template<size_t Types>
+    void benchmark_types(std::ostream& out) {
+        const size_t count = 1000000;
+        const auto types = std::make_index_sequence<Types>();
+
+        // 对照组：dynamic_cast 链
+        int64_t castSum = 0;
+        auto events = make_events(count, types);
+        auto start = Clock::now();
+        for (auto& event : events) {
+            dispatch_by_cast(*event, castSum, types);
+            event.reset();
+        }
+        double castNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+        // 按类型编号查表分派
+        int64_t tableSum = 0;
+        EventSystem::EventHandler handler;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (handler.on<BenchEvent<I>>([&tableSum](BenchEvent<I>& e) { tableSum += e.getValue(); }), ...);
+        }(types);
+        for (auto& event : make_events(count, types)) {
+            handler.add_event(std::move(event));
+        }
+        start = Clock::now();
+        handler.process_events();
+        double tableNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+        out << std::left << std::setw(10) << Types << std::fixed << std::setprecision(1)
+            << std::setw(18) << castNs << std::setw(14) << tableNs
+            << (castSum == tableSum ? "" : "结果不一致!") << "\n";
+    }
+
+    void benchmark_dispatch(std::ostream& out) {
+        out << "\n=== 事件分派 (1M 个事件，各类型轮流出现，ns/事件，含事件析构) ===\n";
+        out << "类型数    dynamic_cast 链   类型编号查表\n";
+        benchmark_types<2>(out);
+        benchmark_types<16>(out);
+        benchmark_types<64>(out);
+    }
+
+    template<typename Handler, typename Emplace>
+    std::pair<double, double> run_rounds(Handler& handler, Emplace&& emplace, int64_t& sum) {
+        const size_t rounds = 1000;
+        const size_t batch = 1000;
+        // 预热一轮：让队列与缓冲区达到稳定容量
+        for (size_t i = 0; i < batch; ++i) {
+            emplace(handler, static_cast<int>(i));
+        }
+        handler.process_events();
+        sum = 0;
+
+        const size_t allocationsBefore = allocations.load(std::memory_order_relaxed);
+        auto start = Clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < batch; ++i) {
+                emplace(handler, static_cast<int>(i));
+            }
+            handler.process_events();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double events = static_cast<double>(rounds * batch);
+        const double allocated = static_cast<double>(allocations.load(std::memory_order_relaxed) - allocationsBefore);
+        return {events / seconds / 1e6, allocated / events};
+    }
+
+    void benchmark_inline(std::ostream& out) {
+        out << "\n=== 事件存储 (2 种事件类型, 每轮 1000 个事件, 1000 轮) ===\n";
+        out << "存储方式                  M 事件/s    每事件堆分配\n";
+
+        using E0 = BenchEvent<0>;
+        using E1 = BenchEvent<1>;
+        int64_t queueSum = 0;
+        int64_t inlineSum = 0;
+
+        EventSystem::EventHandler queue;
+        queue.on<E0>([&queueSum](E0& e) { queueSum += e.getValue(); });
+        queue.on<E1>([&queueSum](E1& e) { queueSum -= e.getValue(); });
+        auto [queueRate, queueAllocs] = run_rounds(queue, [](auto& h, int v) {
+            if (v & 1) {
+                h.template emplace_event<E1>(v);
+            } else {
+                h.template emplace_event<E0>(v);
+            }
+        }, queueSum);
+
+        EventSystem::VariantEventHandler<E0, E1> ring;
+        ring.on<E0>([&inlineSum](E0& e) { inlineSum += e.getValue(); });
+        ring.on<E1>([&inlineSum](E1& e) { inlineSum -= e.getValue(); });
+        auto [ringRate, ringAllocs] = run_rounds(ring, [](auto& h, int v) {
+            if (v & 1) {
+                h.template emplace_event<E1>(v);
+            } else {
+                h.template emplace_event<E0>(v);
+            }
+        }, inlineSum);
+
+        out << std::fixed << std::setprecision(2);
+        out << "unique_ptr 队列           " << std::left << std::setw(12) << queueRate << queueAllocs << "\n";
+        out << "variant 环形缓冲区        " << std::left << std::setw(12) << ringRate << ringAllocs
+            << (queueSum == inlineSum ? "" : "  结果不一致!") << "\n";
+    }
+
+    // 对照组：互斥锁保护的 std::queue，消费者在锁内交换出整个队列后在锁外处理
+    class LockedQueue {
+    private:
+        std::mutex mutex;
+        std::queue<std::unique_ptr<EventSystem::Event>> queue;
+        int64_t& sum;
+
+    public:
+        explicit LockedQueue(int64_t& s) : sum(s) {}
+
+        template<typename E, typename... Args>
+        void emplace_event(Args&&... args) {
+            auto event = std::make_unique<E>(std::forward<Args>(args)...);
+            std::lock_guard lock(mutex);
+            queue.push(std::move(event));
+        }
+
+        size_t process_events() {
+            std::queue<std::unique_ptr<EventSystem::Event>> batch;
+            {
+                std::lock_guard lock(mutex);
+                batch.swap(queue);
+            }
+            const size_t processed = batch.size();
+            for (; !batch.empty(); batch.pop()) {
+                sum += static_cast<BenchEvent<0>&>(*batch.front()).getValue();
+            }
+            return processed;
+        }
+    };
+
+    // 返回 M 事件/s：producers 个线程各加入 perProducer 个事件，调用线程作为消费者处理到全部完成
+    template<typename Handler>
+    double run_producers(Handler& handler, size_t producers, size_t perProducer) {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&handler, &go, perProducer] {
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < perProducer; ++i) {
+                    handler.template emplace_event<BenchEvent<0>>(static_cast<int>(i));
+                }
+            });
+        }
+        const size_t total = producers * perProducer;
+        size_t processed = 0;
+        auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        while (processed < total) {
+            const size_t batch = handler.process_events();
+            if (batch == 0) {
+                std::this_thread::yield();
+            }
+            processed += batch;
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        for (auto& t : threads) {
+            t.join();
+        }
+        return static_cast<double>(total) / seconds / 1e6;
+    }
+
+    void benchmark_producers(std::ostream& out) {
+        const size_t perProducer = 200000;
+        out << "\n=== 多生产者入队 (每个生产者 200K 个事件, 1 个消费者, 硬件线程数 "
+            << std::thread::hardware_concurrency() << ", M 事件/s) ===\n";
+        out << "生产者    互斥锁 + std::queue   MPSC 队列\n";
+        for (size_t producers : {1, 2, 4, 8}) {
+            int64_t lockedSum = 0;
+            LockedQueue locked(lockedSum);
+            const double lockedRate = run_producers(locked, producers, perProducer);
+
+            int64_t mpscSum = 0;
+            EventSystem::EventHandler handler;
+            handler.on<BenchEvent<0>>([&mpscSum](BenchEvent<0>& e) { mpscSum += e.getValue(); });
+            const double mpscRate = run_producers(handler, producers, perProducer);
+
+            out << std::left << std::fixed << std::setprecision(2) << std::setw(10) << producers
+                << std::setw(22) << lockedRate << mpscRate
+                << (lockedSum == mpscSum ? "" : "  结果不一致!") << "\n";
+        }
+    }
+
+    // 突发 burst 个事件，反复调用 drain(handler) 直到它返回 false（队列已空）：返回 {调用次数, 单次最长 ms, M 事件/s}
+    template<typename Drain>
+    std::tuple<size_t, double, double> run_burst(size_t burst, Drain&& drain) {
+        int64_t sum = 0;
+        EventSystem::EventHandler handler;
+        handler.on<BenchEvent<0>>([&sum](BenchEvent<0>& e) {
+            // 模拟有一定工作量的处理函数
+            for (int i = 0; i < 16; ++i) {
+                sum += (e.getValue() ^ i) & 7;
+            }
+        });
+        for (size_t i = 0; i < burst; ++i) {
+            handler.emplace_event<BenchEvent<0>>(static_cast<int>(i));
+        }
+        size_t calls = 0;
+        double longest = 0;
+        auto start = Clock::now();
+        for (bool pending = true; pending;) {
+            auto callStart = Clock::now();
+            pending = drain(handler);
+            longest = std::max(longest, std::chrono::duration<double, std::milli>(Clock::now() - callStart).count());
+            ++calls;
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return {calls, longest, static_cast<double>(burst) / seconds / 1e6};
+    }
+
+    void benchmark_budget(std::ostream& out) {
+        const size_t burst = 100000;
+        out << "\n=== 限量处理 (突发 100K 个事件，每次调用处理到限制为止，直到队列为空) ===\n";
+        out << "处理方式                        调用次数  单次最长(ms)  M 事件/s\n";
+        auto report = [&out](const char* name, std::tuple<size_t, double, double> r) {
+            out << name << std::left << std::setw(10) << std::get<0>(r) << std::fixed << std::setprecision(3)
+                << std::setw(14) << std::get<1>(r) << std::setprecision(2) << std::get<2>(r) << "\n";
+        };
+        report("一次全部处理                    ", run_burst(burst, [](auto& h) {
+            h.process_events();
+            return false;
+        }));
+        report("每次最多 1000 个                ", run_burst(burst, [](auto& h) {
+            return h.process_events(1000, std::chrono::hours(1)).pending;
+        }));
+        report("每次最多 0.5ms                  ", run_burst(burst, [](auto& h) {
+            return h.process_events(SIZE_MAX, std::chrono::microseconds(500)).pending;
+        }));
+        report("每次最多 10000 个或 0.1ms       ", run_burst(burst, [](auto& h) {
+            return h.process_events(10000, std::chrono::microseconds(100)).pending;
+        }));
+    }
+
+    // 对照组：旧的事件头，每个事件带一个 std::string 类型名（不含旧实现中的日志输出）
+    class StringTypedEvent {
+    private:
+        std::string type;
+        std::chrono::steady_clock::time_point timestamp;
+        uint32_t typeId;
+
+    public:
+        StringTypedEvent(std::string t, uint32_t id)
+            : type(std::move(t)), timestamp(Clock::now()), typeId(id) {}
+        virtual ~StringTypedEvent() = default;
+
+        const std::string& getType() const { return type; }
+        uint32_t getTypeId() const { return typeId; }
+    };
+
+    class StringTypedInputEvent : public StringTypedEvent {
+    private:
+        int value;
+
+    public:
+        explicit StringTypedInputEvent(int v) : StringTypedEvent("KeyboardInputEvent", 0), value(v) {}
+
+        int getValue() const { return value; }
+    };
+
+    class CompactInputEvent : public EventSystem::EventOf<CompactInputEvent> {
+    private:
+        int value;
+
+    public:
+        static constexpr std::string_view kEventName = "KeyboardInputEvent";
+
+        explicit CompactInputEvent(int v) : value(v) {}
+
+        int getValue() const { return value; }
+    };
+
+    // 创建 + 销毁 count 个事件的 ns/事件（一次创建一批再统一销毁，包含堆分配）
+    template<typename E>
+    double create_destroy_ns(size_t count, int64_t& sum) {
+        std::vector<std::unique_ptr<E>> events(count);
+        auto start = Clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            events[i] = std::make_unique<E>(static_cast<int>(i));
+        }
+        for (auto& event : events) {
+            sum += event->getValue() + static_cast<int64_t>(event->getType().size());
+            event.reset();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(count);
+    }
+
+    void benchmark_header(std::ostream& out) {
+        const size_t count = 1000000;
+        int64_t stringSum = 0;
+        int64_t compactSum = 0;
+        create_destroy_ns<CompactInputEvent>(count / 10, compactSum);
+        const double stringNs = create_destroy_ns<StringTypedInputEvent>(count, stringSum);
+        compactSum = 0;
+        const double compactNs = create_destroy_ns<CompactInputEvent>(count, compactSum);
+
+        out << "\n=== 事件头 (1M 个事件，类型名 \"KeyboardInputEvent\" 超出短字符串优化长度) ===\n";
+        out << "事件头                    事件大小(字节)  创建+销毁(ns/事件)\n";
+        out << std::fixed << std::setprecision(1);
+        out << "std::string 类型名        " << std::left << std::setw(16) << sizeof(StringTypedInputEvent)
+            << stringNs << "\n";
+        out << "类型编号 + 名称表         " << std::left << std::setw(16) << sizeof(CompactInputEvent)
+            << compactNs << (stringSum == compactSum ? "" : "  结果不一致!") << "\n";
+    }
+
+    bool selected(int argc, char** argv, const char* name) {
+        return argc < 2 || std::strcmp(argv[1], name) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "事件系统基准测试\n";
+    std::cout << "================\n";
+
+    if (selected(argc, argv, "dispatch")) {
+        benchmark_dispatch(std::cout);
+    }
+    if (selected(argc, argv, "inline")) {
+        benchmark_inline(std::cout);
+    }
+    if (selected(argc, argv, "producers")) {
+        benchmark_producers(std::cout);
+    }
+    if (selected(argc, argv, "budget")) {
+        benchmark_budget(std::cout);
+    }
+    if (selected(argc, argv, "header")) {
+        benchmark_header(std::cout);
+    }
+    return 0;
+}
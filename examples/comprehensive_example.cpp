@@ -1,5 +1,6 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <utility>
@@ -7,8 +8,17 @@
 #include <chrono>
 #include <functional>
 #include <map>
+#include <optional>
 #include <queue>
 #include <numeric>
+#include <filesystem>
+
+#include "cache_system/buffer_pool.hpp"
+#include "cache_system/compressed_cache.hpp"
+#include "cache_system/lru_cache.hpp"
+#include "cache_system/tiered_cache.hpp"
+#include "event_system/event_handler.hpp"
+#include "event_system/variant_event_handler.hpp"
 
 /**
  * 综合示例：右值引用和完美转发的实际应用
@@ -94,45 +104,24 @@ namespace SmartPointerFactory {
 
 /**
  * 2. 事件系统 - 演示移动语义在事件处理中的应用
+ *
+ * Event 与 EventHandler 的实现位于 include/event_system/event_handler.hpp，
+ * 内联存储的 VariantEventHandler 位于 include/event_system/variant_event_handler.hpp
  */
 namespace EventSystem {
     
-    // 事件基类
-    class Event {
-    private:
-        std::string type;
-        std::chrono::steady_clock::time_point timestamp;
-        
-    public:
-        Event(std::string t) : type(std::move(t)), timestamp(std::chrono::steady_clock::now()) {
-            std::cout << "Event 创建: " << type << "\n";
-        }
-        
-        Event(const Event& other) : type(other.type), timestamp(other.timestamp) {
-            std::cout << "Event 拷贝: " << type << "\n";
-        }
-        
-        Event(Event&& other) noexcept 
-            : type(std::move(other.type)), timestamp(other.timestamp) {
-            std::cout << "Event 移动: " << type << "\n";
-        }
-        
-        virtual ~Event() {
-            std::cout << "Event 析构: " << type << "\n";
-        }
-        
-        const std::string& getType() const { return type; }
-        auto getTimestamp() const { return timestamp; }
-    };
-    
     // 具体事件类型
-    class MouseEvent : public Event {
+    class MouseEvent : public EventOf<MouseEvent> {
     private:
         int x, y;
         
     public:
+        // 名称表中使用的类型名；不定义时取编译器给出的带命名空间的类型名
+        // （如 KeyboardEvent 的 "EventSystem::KeyboardEvent"）
+        static constexpr std::string_view kEventName = "MouseEvent";
+        
         MouseEvent(int x_pos, int y_pos) 
-            : Event("MouseEvent"), x(x_pos), y(y_pos) {
+            : x(x_pos), y(y_pos) {
             std::cout << "MouseEvent 创建: (" << x << ", " << y << ")\n";
         }
         
@@ -140,59 +129,22 @@ namespace EventSystem {
         int getY() const { return y; }
     };
     
-    class KeyboardEvent : public Event {
+    class KeyboardEvent : public EventOf<KeyboardEvent> {
     private:
         char key;
         
     public:
-        KeyboardEvent(char k) : Event("KeyboardEvent"), key(k) {
+        KeyboardEvent(char k) : key(k) {
             std::cout << "KeyboardEvent 创建: '" << key << "'\n";
         }
         
         char getKey() const { return key; }
     };
     
-    // 事件处理器
-    class EventHandler {
-    private:
-        std::queue<std::unique_ptr<Event>> eventQueue;
-        
-    public:
-        // 完美转发添加事件
-        template<typename EventType, typename... Args>
-        void emplace_event(Args&&... args) {
-            auto event = std::make_unique<EventType>(std::forward<Args>(args)...);
-            eventQueue.push(std::move(event));
-            std::cout << "事件已添加到队列\n";
-        }
-        
-        // 移动语义添加事件
-        void add_event(std::unique_ptr<Event> event) {
-            std::cout << "通过移动添加事件: " << event->getType() << "\n";
-            eventQueue.push(std::move(event));
-        }
-        
-        // 处理事件
-        void process_events() {
-            std::cout << "\n处理事件队列 (大小: " << eventQueue.size() << ")\n";
-            
-            while (!eventQueue.empty()) {
-                auto event = std::move(eventQueue.front());
-                eventQueue.pop();
-                
-                std::cout << "处理事件: " << event->getType() << "\n";
-                
-                // 根据事件类型进行不同处理
-                if (auto mouseEvent = dynamic_cast<MouseEvent*>(event.get())) {
-                    std::cout << "  鼠标位置: (" << mouseEvent->getX() 
-                              << ", " << mouseEvent->getY() << ")\n";
-                } else if (auto keyEvent = dynamic_cast<KeyboardEvent*>(event.get())) {
-                    std::cout << "  按键: '" << keyEvent->getKey() << "'\n";
-                }
-            }
-        }
-        
-        size_t getQueueSize() const { return eventQueue.size(); }
+    // 把多个 lambda 合成一个 std::visit 访问者
+    template<typename... Fs>
+    struct Overloaded : Fs... {
+        using Fs::operator()...;
     };
     
     void demonstrate() {
@@ -200,6 +152,16 @@ namespace EventSystem {
         
         EventHandler handler;
         
+        // 按事件类型登记处理函数：分派是一次按类型编号的查表，不再逐个 dynamic_cast
+        handler.on<MouseEvent>([](MouseEvent& event) {
+            std::cout << "处理事件: " << event.getType() << "\n";
+            std::cout << "  鼠标位置: (" << event.getX() << ", " << event.getY() << ")\n";
+        });
+        handler.on<KeyboardEvent>([](KeyboardEvent& event) {
+            std::cout << "处理事件: " << event.getType() << "\n";
+            std::cout << "  按键: '" << event.getKey() << "'\n";
+        });
+        
         // 使用 emplace 直接构造事件
         handler.emplace_event<MouseEvent>(100, 200);
         handler.emplace_event<KeyboardEvent>('A');
@@ -207,10 +169,37 @@ namespace EventSystem {
         
         // 使用移动语义添加事件
         auto keyEvent = std::make_unique<KeyboardEvent>('B');
+        std::cout << "通过移动添加事件: " << keyEvent->getType() << "\n";
         handler.add_event(std::move(keyEvent));
         
         // 处理所有事件
+        std::cout << "\n处理事件队列 (大小: " << handler.getQueueSize() << ")\n";
         handler.process_events();
+        
+        // 限量处理：每次最多处理 2 个事件或 1ms，剩余的留给下一次（例如下一帧）
+        std::cout << "\n限量处理事件:\n";
+        for (int x = 0; x < 3; ++x) {
+            handler.emplace_event<MouseEvent>(x, x);
+        }
+        for (bool pending = true; pending;) {
+            ProcessResult result = handler.process_events(2, std::chrono::milliseconds(1));
+            pending = result.pending;
+            // getQueueSize() 遍历队列，只在需要具体数目时调用
+            std::cout << "  本次处理 " << result.processed << " 个, 剩余 " << handler.getQueueSize() << " 个\n";
+        }
+        
+        // 封闭的事件类型集合：事件按值原地构造在环形缓冲区中，没有逐事件的堆分配
+        std::cout << "\n内联存储的事件处理器:\n";
+        VariantEventHandler<MouseEvent, KeyboardEvent> inlineHandler;
+        inlineHandler.emplace_event<MouseEvent>(500, 600);
+        inlineHandler.emplace_event<KeyboardEvent>('C');
+        inlineHandler.process_events(Overloaded{
+            [](MouseEvent& event) {
+                std::cout << "  鼠标位置: (" << event.getX() << ", " << event.getY() << ")\n";
+            },
+            [](KeyboardEvent& event) {
+                std::cout << "  按键: '" << event.getKey() << "'\n";
+            }});
     }
 }
 
@@ -342,81 +331,11 @@ namespace TaskScheduler {
 
 /**
  * 4. 缓存系统 - 演示移动语义在缓存管理中的应用
+ *
+ * LRUCache 的实现位于 include/cache_system/lru_cache.hpp
  */
 namespace CacheSystem {
     
-    template<typename Key, typename Value>
-    class LRUCache {
-    private:
-        struct CacheNode {
-            Key key;
-            Value value;
-            
-            CacheNode(Key k, Value v) : key(std::move(k)), value(std::move(v)) {}
-        };
-        
-        std::vector<CacheNode> cache;
-        size_t maxSize;
-        
-    public:
-        explicit LRUCache(size_t size) : maxSize(size) {
-            cache.reserve(size);
-        }
-        
-        // 完美转发插入
-        template<typename K, typename V>
-        void put(K&& key, V&& value) {
-            // 查找是否已存在
-            auto it = std::find_if(cache.begin(), cache.end(),
-                [&key](const CacheNode& node) { return node.key == key; });
-            
-            if (it != cache.end()) {
-                // 更新现有值并移动到末尾
-                it->value = std::forward<V>(value);
-                std::rotate(it, it + 1, cache.end());
-                std::cout << "缓存更新: " << key << "\n";
-            } else {
-                // 添加新项
-                if (cache.size() >= maxSize) {
-                    std::cout << "缓存满，移除最旧项: " << cache.front().key << "\n";
-                    cache.erase(cache.begin());
-                }
-                
-                cache.emplace_back(std::forward<K>(key), std::forward<V>(value));
-                std::cout << "缓存添加: " << key << "\n";
-            }
-        }
-        
-        // 获取值（移动语义）
-        std::pair<bool, Value> get(const Key& key) {
-            auto it = std::find_if(cache.begin(), cache.end(),
-                [&key](const CacheNode& node) { return node.key == key; });
-            
-            if (it != cache.end()) {
-                // 移动到末尾（最近使用）
-                Value result = std::move(it->value);
-                std::rotate(it, it + 1, cache.end());
-                std::cout << "缓存命中: " << key << "\n";
-                return {true, std::move(result)};
-            }
-            
-            std::cout << "缓存未命中: " << key << "\n";
-            // 为没有默认构造函数的类型创建一个临时对象
-            static Value empty_value = Value("", 0);
-            return {false, empty_value};
-        }
-        
-        void print_cache() const {
-            std::cout << "缓存内容 (从旧到新): ";
-            for (const auto& node : cache) {
-                std::cout << "[" << node.key << "] ";
-            }
-            std::cout << "\n";
-        }
-        
-        size_t size() const { return cache.size(); }
-    };
-    
     // 大对象用于演示移动语义的优势
     class LargeObject {
     private:
@@ -430,6 +349,20 @@ namespace CacheSystem {
             std::cout << "LargeObject 构造: " << name << " (大小: " << size << ")\n";
         }
         
+        // 使用缓冲区池中取出的缓冲区，不再重新分配
+        LargeObject(std::string n, size_t size, std::vector<int> buffer)
+            : data(std::move(buffer)), name(std::move(n)) {
+            data.resize(size);
+            std::iota(data.begin(), data.end(), 0);
+            std::cout << "LargeObject 构造(池缓冲区): " << name << " (大小: " << size << ")\n";
+        }
+        
+        // 从快照恢复：直接接管读回的数据
+        LargeObject(std::string n, std::vector<int> d)
+            : data(std::move(d)), name(std::move(n)) {
+            std::cout << "LargeObject 恢复: " << name << " (大小: " << data.size() << ")\n";
+        }
+        
         LargeObject(const LargeObject& other) 
             : data(other.data), name(other.name + "_copy") {
             std::cout << "LargeObject 拷贝: " << name << "\n";
@@ -463,7 +396,25 @@ namespace CacheSystem {
         }
         
         const std::string& getName() const { return name; }
+        const std::vector<int>& getData() const { return data; }
         size_t getDataSize() const { return data.size(); }
+        
+        // 交出数据缓冲区（供淘汰后回收）
+        std::vector<int> releaseData() && { return std::move(data); }
+    };
+    
+    // 快照序列化：名字和数据都作为连续的原始块写入
+    template<>
+    struct Serializer<LargeObject> {
+        static void write(SnapshotWriter& out, const LargeObject& obj) {
+            Serializer<std::string>::write(out, obj.getName());
+            Serializer<std::vector<int>>::write(out, obj.getData());
+        }
+        
+        static LargeObject read(SnapshotReader& in) {
+            std::string name = Serializer<std::string>::read(in);
+            return LargeObject(std::move(name), Serializer<std::vector<int>>::read(in));
+        }
     };
     
     void demonstrate() {
@@ -478,11 +429,18 @@ namespace CacheSystem {
         
         cache.print_cache();
         
-        // 访问缓存
-        auto [found1, obj1] = cache.get("obj1");
-        if (found1) {
-            std::cout << "获取到对象: " << obj1.getName() 
-                      << " (数据大小: " << obj1.getDataSize() << ")\n";
+        // 访问缓存：Handle 直接引用缓存中的对象，不发生拷贝或移动
+        {
+            auto obj1 = cache.get("obj1");
+            if (obj1) {
+                std::cout << "获取到对象: " << obj1->getName() 
+                          << " (数据大小: " << obj1->getDataSize() << ")\n";
+            }
+            
+            // 再次命中同一个键，得到的仍是完整的对象
+            auto again = cache.get("obj1");
+            std::cout << "再次获取: " << again->getName() 
+                      << " (数据大小: " << again->getDataSize() << ")\n";
         }
         
         cache.print_cache();
@@ -492,11 +450,119 @@ namespace CacheSystem {
         
         cache.print_cache();
         
-        // 尝试访问被淘汰的对象
-        auto [found2, obj2] = cache.get("obj2");
-        if (!found2) {
+        // 尝试访问被淘汰的对象：未命中不构造任何对象
+        if (!cache.get("obj2")) {
             std::cout << "对象2已被淘汰\n";
         }
+        
+        // 未命中时加载：同一个键的并发调用只会构造一次对象
+        {
+            auto obj2 = cache.get_or_compute("obj2", [] { return LargeObject("对象2", 2000); });
+            std::cout << "加载得到: " << obj2->getName() << "\n";
+        }
+        
+        // 否定查找缓存：确认不存在的键记入布隆过滤器，再次查找时不再调用加载函数
+        cache.enable_negative_cache(1000);
+        auto loadMissing = [] {
+            std::cout << "加载函数: 数据源中没有 obj9\n";
+            return std::optional<LargeObject>();
+        };
+        cache.get_or_load("obj9", loadMissing);
+        if (!cache.get_or_load("obj9", loadMissing)) {
+            std::cout << "obj9 不存在，省下的加载次数: " << cache.loader_calls_avoided() << "\n";
+        }
+        
+        // 运行统计：计数与采样的延迟直方图，替代逐操作的日志
+        CacheStats stats = cache.stats();
+        std::cout << "命中: " << stats.hits << ", 未命中: " << stats.misses
+                  << ", 插入: " << stats.inserts << ", 更新: " << stats.updates
+                  << ", 淘汰: " << stats.evictions << ", 命中率: " << stats.hit_rate() << "\n";
+        
+        // 按字节计量容量：不同大小的对象占用不同的预算
+        std::cout << "\n按字节计量的缓存 (容量 28000 字节):\n";
+        LRUCache<std::string, LargeObject> byteCache(28000,
+            [](const std::string&, const LargeObject& obj) {
+                return obj.getDataSize() * sizeof(int);
+            });
+        
+        byteCache.put("obj1", LargeObject("对象1", 1000));
+        byteCache.put("obj2", LargeObject("对象2", 2000));
+        byteCache.put("obj3", LargeObject("对象3", 3000));
+        std::cout << "当前占用: " << byteCache.total_weight() << " 字节\n";
+        
+        // 放入 16000 字节的对象需要连续淘汰两个最旧的条目
+        byteCache.put("obj4", LargeObject("对象4", 4000));
+        std::cout << "当前占用: " << byteCache.total_weight() << " 字节, 条目数: " 
+                  << byteCache.size() << "\n";
+        byteCache.print_cache();
+        
+        // 带过期时间的条目：访问时惰性过期，tick() 通过时间轮主动清理
+        std::cout << "\n带 TTL 的缓存:\n";
+        LRUCache<std::string, std::string> sessionCache(10);
+        sessionCache.put("session1", std::string("用户A"), std::chrono::seconds(30));
+        sessionCache.put("session2", std::string("用户B"), std::chrono::minutes(10));
+        
+        auto oneMinuteLater = std::chrono::steady_clock::now() + std::chrono::minutes(1);
+        size_t expiredCount = sessionCache.tick(oneMinuteLater);
+        std::cout << "一分钟后清理的过期条目数: " << expiredCount << "\n";
+        sessionCache.print_cache();
+        
+        // 热重启：保存快照，新的缓存实例按原来的最近使用顺序恢复
+        std::cout << "\n快照保存与恢复:\n";
+        auto snapshotPath = (std::filesystem::temp_directory_path() / "lru_cache_demo.snapshot").string();
+        byteCache.save_snapshot(snapshotPath);
+        LRUCache<std::string, LargeObject> restored(28000,
+            [](const std::string&, const LargeObject& obj) {
+                return obj.getDataSize() * sizeof(int);
+            });
+        size_t restoredCount = restored.load_snapshot(snapshotPath);
+        std::cout << "恢复条目数: " << restoredCount << "\n";
+        restored.print_cache();
+        std::filesystem::remove(snapshotPath);
+        
+        // 淘汰监听器：被淘汰对象的缓冲区回收到池中，新对象直接复用，不再 malloc/free
+        std::cout << "\n回收被淘汰对象的缓冲区:\n";
+        BufferPool<int, detail::NullLock> pool;
+        LRUCache<std::string, LargeObject> recycling(2);
+        recycling.set_eviction_listener(recycle_into(pool, [](LargeObject&& obj) {
+            return std::move(obj).releaseData();
+        }));
+        for (int i = 1; i <= 4; ++i) {
+            std::string id = std::to_string(i);
+            recycling.put("obj" + id, LargeObject("对象" + id, 1000, pool.acquire(1000)));
+        }
+        size_t allocatedBuffers = pool.allocation_count();
+        size_t reusedBuffers = pool.reuse_count();
+        std::cout << "新分配缓冲区: " << allocatedBuffers << ", 复用缓冲区: " << reusedBuffers << "\n";
+        
+        // 两层缓存：被淘汰的对象写入映射的溢出文件，再次访问时从文件读回并提升
+        std::cout << "\n两层缓存 (内存 2 个条目 + 溢出文件):\n";
+        auto spillPath = (std::filesystem::temp_directory_path() / "lru_cache_demo.spill").string();
+        TieredCache<std::string, LargeObject> tiered(2, spillPath, 1 << 20);
+        tiered.put("obj1", LargeObject("对象1", 1000));
+        tiered.put("obj2", LargeObject("对象2", 2000));
+        tiered.put("obj3", LargeObject("对象3", 3000));
+        std::cout << "溢出文件中的条目数: " << tiered.spilled() << "\n";
+        if (auto obj1 = tiered.get("obj1")) {
+            std::cout << "从溢出文件读回: " << obj1->getName()
+                      << " (数据大小: " << obj1->getDataSize() << ")\n";
+        }
+        size_t spillHits = tiered.spill_hits();
+        std::cout << "溢出层命中次数: " << spillHits << "\n";
+
+        // 冷条目压缩：被挤出热段的整数序列以增量/游程编码保存，再次访问时解码
+        std::cout << "\n冷条目压缩缓存 (热段 2 个条目):\n";
+        CompressedCache<std::string, int> compressed(2, 64 << 10);
+        for (int i = 1; i <= 3; ++i) {
+            std::vector<int> sequence(static_cast<size_t>(i) * 1000);
+            std::iota(sequence.begin(), sequence.end(), 0);
+            compressed.put("seq" + std::to_string(i), std::move(sequence));
+        }
+        std::cout << "冷段条目数: " << compressed.cold_size()
+                  << ", 压缩比: " << compressed.compression_ratio() << "\n";
+        if (auto seq1 = compressed.get("seq1")) {
+            std::cout << "解码后的 seq1 长度: " << seq1->size() << ", 末尾元素: " << seq1->back() << "\n";
+        }
     }
 }
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * 按容量分级的缓冲区池 - 回收被淘汰值的 std::vector 缓冲区
+ *
+ * 缓冲区按容量分到 2 的幂大小级别中：容量至少为 2^c 的缓冲区放入第 c 级，
+ * acquire(n) 从能容纳 n 个元素的最小级别取出，因此取出的缓冲区不需要扩容。
+ * 配合 LRUCache 的淘汰监听器（recycle_into）使用：被淘汰的值把缓冲区交还
+ * 给池，新构造的值再从池中取用，条目持续换入换出时 put 路径不再调用
+ * malloc/free。
+ *
+ * 每级最多保留 maxPerClass 个缓冲区，多余的直接释放，池占用的内存有上限。
+ * 淘汰监听器在缓存的锁外、可能在多个线程上调用，因此默认使用 std::mutex；
+ * 只在单线程中使用时可以传入空锁。
+ */
+namespace CacheSystem {
+
+    template<typename T, typename Lock = std::mutex>
+    class BufferPool {
+    private:
+        static constexpr size_t kMinClass = 4;   // 小于 16 个元素的缓冲区不值得回收
+        static constexpr size_t kClasses = 40;
+
+        std::vector<std::vector<T>> freeLists[kClasses];
+        size_t maxPerClass;
+        size_t reused = 0;
+        size_t allocated = 0;
+        mutable Lock mutex;
+
+        // 能容纳 n 个元素的最小级别
+        static size_t class_for(size_t n) noexcept {
+            size_t c = n <= 1 ? 0 : static_cast<size_t>(std::bit_width(n - 1));
+            return c < kMinClass ? kMinClass : c;
+        }
+
+    public:
+        explicit BufferPool(size_t maxBuffersPerClass = 64) : maxPerClass(maxBuffersPerClass) {}
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        // 取出一个容量不小于 n 的空缓冲区，池中没有时新分配
+        std::vector<T> acquire(size_t n) {
+            const size_t c = class_for(n);
+            if (c < kClasses) {
+                std::lock_guard<Lock> guard(mutex);
+                auto& list = freeLists[c];
+                if (!list.empty()) {
+                    std::vector<T> buffer = std::move(list.back());
+                    list.pop_back();
+                    ++reused;
+                    return buffer;
+                }
+                ++allocated;
+            }
+            std::vector<T> buffer;
+            buffer.reserve(c < kClasses ? size_t{1} << c : n);
+            return buffer;
+        }
+
+        // 交还缓冲区；太小或所在级别已满时直接释放
+        void release(std::vector<T>&& buffer) noexcept {
+            const size_t capacity = buffer.capacity();
+            if (capacity < (size_t{1} << kMinClass)) {
+                return;
+            }
+            const size_t c = std::min(static_cast<size_t>(std::bit_width(capacity)) - 1, kClasses - 1);
+            buffer.clear();
+            std::lock_guard<Lock> guard(mutex);
+            auto& list = freeLists[c];
+            if (list.size() >= maxPerClass) {
+                return;
+            }
+            try {
+                list.push_back(std::move(buffer));
+            } catch (...) {
+                // 空闲列表扩容失败时放弃回收，缓冲区随参数析构
+            }
+        }
+
+        // 从池中取用的次数 / 池中没有可用缓冲区而新分配的次数
+        size_t reuse_count() const {
+            std::lock_guard<Lock> guard(mutex);
+            return reused;
+        }
+
+        size_t allocation_count() const {
+            std::lock_guard<Lock> guard(mutex);
+            return allocated;
+        }
+
+        // 池中当前保存的缓冲区数
+        size_t pooled() const {
+            std::lock_guard<Lock> guard(mutex);
+            size_t total = 0;
+            for (const auto& list : freeLists) {
+                total += list.size();
+            }
+            return total;
+        }
+    };
+
+    /**
+     * 把被淘汰的值的缓冲区交还给 pool 的淘汰监听器
+     * take(Value&&) 从值中取出 std::vector<T>；值本身就是 std::vector<T> 时可以省略
+     */
+    template<typename T, typename Lock, typename Take>
+    auto recycle_into(BufferPool<T, Lock>& pool, Take take) {
+        return [&pool, take = std::move(take)](auto&&, auto&& value) {
+            pool.release(take(std::move(value)));
+        };
+    }
+
+    template<typename T, typename Lock>
+    auto recycle_into(BufferPool<T, Lock>& pool) {
+        return [&pool](auto&&, auto&& value) {
+            pool.release(std::move(value));
+        };
+    }
+
+}
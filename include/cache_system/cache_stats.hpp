@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "cache_system/thread_stripe.hpp"
+
+/**
+ * 缓存统计 - 命中/未命中/插入/更新/淘汰计数与 get/put 延迟直方图
+ *
+ * 计数器按线程分到 kStripes 个条带上，每个条带独占一条缓存行，
+ * 每次操作只对本线程条带做一次 relaxed 原子加，不同线程之间不争用缓存行。
+ * 延迟按 2 的幂分桶（第 i 桶为 [2^(i-1), 2^i) 纳秒），每个线程每 64 次操作
+ * 采样一次，只有被采样的操作才读取时钟，未被采样的操作只多一次线程局部计数。
+ * stats() 在调用时汇总所有条带，得到一份一致性较弱的快照（并发更新时只是近似值）。
+ */
+namespace CacheSystem {
+
+    // 延迟直方图快照：buckets[i] 为落在 [2^(i-1), 2^i) 纳秒内的采样数
+    struct LatencyHistogram {
+        static constexpr size_t kBuckets = 40;
+
+        std::array<uint64_t, kBuckets> buckets{};
+
+        static size_t bucket_for(uint64_t ns) noexcept {
+            return std::min(static_cast<size_t>(std::bit_width(ns)), kBuckets - 1);
+        }
+
+        // 采样总数
+        uint64_t count() const noexcept {
+            uint64_t total = 0;
+            for (uint64_t n : buckets) {
+                total += n;
+            }
+            return total;
+        }
+
+        // 近似分位数（纳秒），返回所在桶的上界；p 取值 [0, 1]
+        uint64_t percentile(double p) const noexcept {
+            const uint64_t total = count();
+            if (total == 0) {
+                return 0;
+            }
+            const auto rank = static_cast<uint64_t>(p * static_cast<double>(total - 1));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBuckets; ++i) {
+                seen += buckets[i];
+                if (seen > rank) {
+                    return uint64_t{1} << i;
+                }
+            }
+            return uint64_t{1} << (kBuckets - 1);
+        }
+
+        void merge(const LatencyHistogram& other) noexcept {
+            for (size_t i = 0; i < kBuckets; ++i) {
+                buckets[i] += other.buckets[i];
+            }
+        }
+    };
+
+    struct CacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t updates = 0;
+        uint64_t evictions = 0;  // 容量淘汰（不含过期与 erase）
+        LatencyHistogram getLatency;
+        LatencyHistogram putLatency;
+
+        double hit_rate() const noexcept {
+            const uint64_t lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+
+        void merge(const CacheStats& other) noexcept {
+            hits += other.hits;
+            misses += other.misses;
+            inserts += other.inserts;
+            updates += other.updates;
+            evictions += other.evictions;
+            getLatency.merge(other.getLatency);
+            putLatency.merge(other.putLatency);
+        }
+    };
+
+    class StatsRecorder {
+    public:
+        enum Counter : size_t { kHits, kMisses, kInserts, kUpdates, kEvictions, kCounters };
+        enum Operation : size_t { kGet, kPut, kOperations };
+
+        static constexpr size_t kStripes = 16;
+        static constexpr uint32_t kSampleMask = 63;  // 每 64 次操作采样一次延迟
+
+        // 在作用域内计时一次操作（只有被采样时才读取时钟）
+        class Timer {
+        private:
+            StatsRecorder& recorder;
+            Operation op;
+            std::chrono::steady_clock::time_point start{};
+            bool sampled;
+
+            static bool should_sample() noexcept {
+                thread_local uint32_t tick = 0;
+                return (++tick & kSampleMask) == 0;
+            }
+
+        public:
+            Timer(StatsRecorder& r, Operation o) noexcept : recorder(r), op(o), sampled(should_sample()) {
+                if (sampled) {
+                    start = std::chrono::steady_clock::now();
+                }
+            }
+
+            Timer(const Timer&) = delete;
+            Timer& operator=(const Timer&) = delete;
+
+            ~Timer() {
+                if (sampled) {
+                    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                    recorder.record_latency(op, static_cast<uint64_t>(elapsed));
+                }
+            }
+        };
+
+    private:
+        struct alignas(64) Stripe {
+            std::atomic<uint64_t> counters[kCounters] = {};
+        };
+
+        Stripe stripes[kStripes];
+        // 直方图只在采样时更新，争用很少，不分条带
+        std::atomic<uint64_t> latency[kOperations][LatencyHistogram::kBuckets] = {};
+
+    public:
+        StatsRecorder() = default;
+        StatsRecorder(const StatsRecorder&) = delete;
+        StatsRecorder& operator=(const StatsRecorder&) = delete;
+
+        void add(Counter counter, uint64_t n = 1) noexcept {
+            stripes[detail::thread_stripe() & (kStripes - 1)].counters[counter]
+                .fetch_add(n, std::memory_order_relaxed);
+        }
+
+        void record_latency(Operation op, uint64_t ns) noexcept {
+            latency[op][LatencyHistogram::bucket_for(ns)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        CacheStats snapshot() const noexcept {
+            uint64_t totals[kCounters] = {};
+            for (const auto& stripe : stripes) {
+                for (size_t c = 0; c < kCounters; ++c) {
+                    totals[c] += stripe.counters[c].load(std::memory_order_relaxed);
+                }
+            }
+            CacheStats result;
+            result.hits = totals[kHits];
+            result.misses = totals[kMisses];
+            result.inserts = totals[kInserts];
+            result.updates = totals[kUpdates];
+            result.evictions = totals[kEvictions];
+            for (size_t i = 0; i < LatencyHistogram::kBuckets; ++i) {
+                result.getLatency.buckets[i] = latency[kGet][i].load(std::memory_order_relaxed);
+                result.putLatency.buckets[i] = latency[kPut][i].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+    };
+
+}
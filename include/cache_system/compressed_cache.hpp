@@ -0,0 +1,138 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "cache_system/lru_cache.hpp"
+#include "cache_system/sequence_codec.hpp"
+
+/**
+ * 冷条目压缩缓存 - 值为整数序列（std::vector<T>）的两段式 LRUCache
+ *
+ * 1. 热段是普通的 LRUCache，按条目数计容量，值以原始形式存放，命中零拷贝
+ * 2. 连续 hotCapacity 次其他条目的访问都没有用到的条目（即被热段容量淘汰的条目）
+ *    视为变冷：淘汰监听器把它编码为 PackedSequence（增量 + varint 或游程，
+ *    见 sequence_codec.hpp）放入冷段；冷段是以编码字节数为权重的 LRUCache
+ * 3. 冷段命中时解码、从冷段移除并放回热段，调用者拿到的仍是热段的 Handle，
+ *    对调用者而言压缩是透明的
+ * 4. hotCapacity 与 coldBytes 的比例就是内存与 CPU 的取舍：热段越大，
+ *    需要解码的访问越少；冷段越大，同样的内存能放下越多条目
+ *    （std::iota 这样的等差序列编码后只有几个字节）
+ *
+ * put 会让冷段中同一个键的旧值失效。与默认的 LRUCache 一样非线程安全，
+ * 不支持 TTL；Handle 不能比缓存活得更久。
+ */
+namespace CacheSystem {
+
+    template<typename Key, std::integral T,
+             template<typename> class Policy = LRUPolicy,
+             typename Hash = typename detail::DefaultLookup<Key>::Hash,
+             typename KeyEqual = typename detail::DefaultLookup<Key>::KeyEqual>
+    class CompressedCache {
+    public:
+        using Value = std::vector<T>;
+        using HotCache = LRUCache<Key, Value, Policy, Hash, KeyEqual>;
+        using ColdCache = LRUCache<Key, PackedSequence<T>, LRUPolicy, Hash, KeyEqual>;
+        using Handle = typename HotCache::Handle;
+
+        // 冷段中每个条目除编码数据外的估计开销（节点、索引槽位、分配头）
+        static constexpr size_t kColdEntryOverhead = 96;
+
+    private:
+        // 冷段必须比热段活得更久：热段析构时不再通知监听器，但仍先析构它
+        ColdCache cold;
+        size_t encodedBytes = 0;  // 进入冷段时的累计编码字节数
+        size_t rawBytes = 0;      // 对应的原始字节数
+        size_t decodes = 0;
+        HotCache hot;
+
+        void freeze(Key&& key, Value&& value) {
+            auto packed = PackedSequence<T>::encode(std::span<const T>(value));
+            encodedBytes += packed.encoded_bytes();
+            rawBytes += packed.raw_bytes();
+            cold.put(std::move(key), std::move(packed));
+        }
+
+        // 把 key 从冷段解码回热段，不在冷段中时返回 false
+        bool thaw(const Key& key) {
+            Value value;
+            {
+                auto packed = cold.get(key);
+                if (!packed) {
+                    return false;
+                }
+                packed->decode_into(value);
+            }
+            cold.erase(key);
+            hot.put(key, std::move(value));
+            ++decodes;
+            return true;
+        }
+
+    public:
+        // hotCapacity 为热段条目数，coldBytes 为冷段编码数据的字节预算
+        CompressedCache(size_t hotCapacity, size_t coldBytes)
+            : cold(coldBytes, [](const Key&, const PackedSequence<T>& packed) {
+                  return packed.encoded_bytes() + kColdEntryOverhead;
+              }),
+              hot(hotCapacity) {
+            hot.set_eviction_listener([this](Key&& key, Value&& value) {
+                freeze(std::move(key), std::move(value));
+            });
+        }
+
+        CompressedCache(const CompressedCache&) = delete;
+        CompressedCache& operator=(const CompressedCache&) = delete;
+
+        template<typename K, typename V>
+        void put(K&& key, V&& value) {
+            Key k(std::forward<K>(key));
+            cold.erase(k);
+            hot.put(std::move(k), std::forward<V>(value));
+        }
+
+        // 先查热段，未命中时从冷段解码并放回热段
+        Handle get(const Key& key) {
+            if (Handle handle = hot.get(key)) {
+                return handle;
+            }
+            return thaw(key) ? hot.get(key) : Handle();
+        }
+
+        bool contains(const Key& key) const {
+            return hot.contains(key) || cold.contains(key);
+        }
+
+        bool erase(const Key& key) {
+            const bool erasedHot = hot.erase(key);
+            const bool erasedCold = cold.erase(key);
+            return erasedHot || erasedCold;
+        }
+
+        void clear() {
+            hot.clear();
+            cold.clear();
+        }
+
+        void print_cache() const { hot.print_cache(); }
+
+        CacheStats stats() const noexcept { return hot.stats(); }
+
+        size_t size() const { return hot.size() + cold.size(); }
+        size_t hot_size() const { return hot.size(); }
+        size_t cold_size() const { return cold.size(); }
+        // 冷段当前占用（含每条目的估计开销）
+        size_t cold_bytes() const { return cold.total_weight(); }
+        size_t decode_count() const noexcept { return decodes; }
+
+        // 进入冷段的数据的平均压缩比（原始字节 / 编码字节）
+        double compression_ratio() const noexcept {
+            return encodedBytes == 0 ? 0.0 : static_cast<double>(rawBytes) / static_cast<double>(encodedBytes);
+        }
+    };
+
+}
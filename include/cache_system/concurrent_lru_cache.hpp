@@ -0,0 +1,465 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "cache_system/epoch.hpp"
+#include "cache_system/eviction_policy.hpp"
+#include "cache_system/lru_cache.hpp"
+
+/**
+ * 读优化的并发 LRU 缓存 - get 不加任何锁
+ *
+ * 面向读远多于写的负载（例如 95% 读）：
+ * 1. 读路径：进入纪元后在原子开放寻址表中查找，命中时增加节点的原子引用计数
+ *    并返回 Handle，全程不碰写锁，读者之间不共享可写的缓存行
+ * 2. 最近使用顺序是近似的：读者把命中键的哈希写入本线程条带上的有损访问缓冲
+ *    （满了就丢弃），写者在持有写锁时把缓冲中的访问批量回放给淘汰策略；
+ *    某个缓冲写满时，读者只尝试 try_lock 顺带回放，拿不到锁就直接返回
+ * 3. 写路径（put/erase/clear）由一把互斥锁串行化，修改表和策略；被摘下的节点和
+ *    扩容前的旧表按纪元延迟回收（见 epoch.hpp），每 32 次写操作维护一次，
+ *    等待回收的对象达到 kMaxRetired 个时立即维护
+ * 4. 回收顺序：先确认读者已离开旧纪元（推进纪元），再回放访问缓冲，最后释放；
+ *    每次维护最多推进两个纪元，没有读者停留在旧纪元时一次就能释放全部对象
+ * 5. 写操作停止后仍有对象等待回收时，读者每隔 kBufferSize 次记录访问就 try_lock
+ *    维护一次，读多写少的阶段不需要调用者手动 maintain() 也能释放内存
+ *
+ * 与 LRUCache 的区别：Handle 持有节点的引用计数（类似 shared_ptr），被持有的
+ * 条目仍可能被淘汰，只是值在最后一个 Handle 释放前保持有效，Handle 也可以
+ * 比缓存活得更久；容量按条目数计量，不支持 Weigher、TTL 和准入过滤。
+ */
+namespace CacheSystem {
+
+    template<typename Key, typename Value,
+             template<typename> class Policy = LRUPolicy,
+             typename Hash = typename detail::DefaultLookup<Key>::Hash,
+             typename KeyEqual = typename detail::DefaultLookup<Key>::KeyEqual>
+    class ConcurrentLRUCache {
+    private:
+        struct Node : detail::PolicyHook {
+            Key key;
+            Value value;
+            std::atomic<uint32_t> refs{1};  // 缓存持有 1 个，直到纪元回收时才放弃
+
+            template<typename K, typename V>
+            Node(size_t h, K&& k, V&& v) : key(std::forward<K>(k)), value(std::forward<V>(v)) {
+                hash = h;
+            }
+        };
+
+        static void unref(Node* node) noexcept {
+            if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete node;
+            }
+        }
+
+    public:
+        // 持有节点引用的只读句柄，不需要缓存的锁，可以比缓存活得更久
+        class Handle {
+        private:
+            friend class ConcurrentLRUCache;
+
+            Node* node = nullptr;
+
+            explicit Handle(Node* n) noexcept : node(n) {}
+
+        public:
+            Handle() noexcept = default;
+
+            Handle(const Handle& other) noexcept : node(other.node) {
+                if (node) {
+                    node->refs.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            Handle(Handle&& other) noexcept : node(std::exchange(other.node, nullptr)) {}
+
+            Handle& operator=(Handle other) noexcept {
+                std::swap(node, other.node);
+                return *this;
+            }
+
+            ~Handle() { reset(); }
+
+            void reset() noexcept {
+                if (node) {
+                    unref(std::exchange(node, nullptr));
+                }
+            }
+
+            explicit operator bool() const noexcept { return node != nullptr; }
+
+            const Key& key() const noexcept { return node->key; }
+            const Value& operator*() const noexcept { return node->value; }
+            const Value* operator->() const noexcept { return &node->value; }
+        };
+
+    private:
+        static constexpr uintptr_t kTombstone = 1;
+        static constexpr size_t kBufferSize = 16;
+        static constexpr size_t kMaintainInterval = 32;  // 每隔多少次写操作维护一次
+        static constexpr size_t kMaxRetired = 256;       // 等待回收的对象达到这么多时立即维护
+
+        // 开放寻址表：槽位先写哈希再发布节点指针，读者按 acquire 读取指针
+        struct Slot {
+            std::atomic<size_t> hash{0};
+            std::atomic<uintptr_t> entry{0};  // 0 空，kTombstone 已删除，否则为 Node*
+        };
+
+        struct Table {
+            size_t mask;
+            size_t used = 0;  // 占用 + 墓碑，只由写者修改
+            std::unique_ptr<Slot[]> slots;
+
+            explicit Table(size_t capacity) : mask(capacity - 1), slots(new Slot[capacity]) {}
+        };
+
+        // 条带上的有损访问缓冲，记录命中键的哈希（0 表示空位）
+        struct alignas(64) ReadBuffer {
+            std::atomic<uint64_t> writes{0};
+            std::atomic<uint64_t> reads{0};
+            std::atomic<size_t> entries[kBufferSize];
+        };
+
+        struct Retired {
+            uint64_t epoch;
+            Node* node;
+            Table* table;
+        };
+
+        mutable EpochDomain domain;
+        std::atomic<Table*> table;
+        std::atomic<bool> reclaimPending{false};  // 有等待回收的对象，由写者在锁内更新
+        ReadBuffer buffers[EpochDomain::kStripes];
+        Hash hasher;
+        KeyEqual equal;
+
+        // 以下成员只在持有 writeMutex 时访问
+        Policy<Node> policy;
+        std::vector<Retired> retired;
+        size_t count = 0;
+        size_t writesSinceMaintain = 0;
+        size_t maxSize;
+        mutable std::mutex writeMutex;
+
+        static size_t mix(size_t hash) noexcept {
+            uint64_t h = static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+
+        static size_t table_size_for(size_t entries) noexcept {
+            // 装载因子（含墓碑）不超过 1/2，线性探测的探测长度保持很短
+            size_t size = 16;
+            while (size < entries * 2) {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        // 读者与写者共用的查找；读者必须处于纪元之内
+        template<typename K>
+        Node* find_in(const Table* t, size_t hash, const K& key) const {
+            for (size_t i = mix(hash) & t->mask;; i = (i + 1) & t->mask) {
+                const Slot& slot = t->slots[i];
+                uintptr_t entry = slot.entry.load(std::memory_order_acquire);
+                if (entry == 0) {
+                    return nullptr;
+                }
+                if (entry == kTombstone || slot.hash.load(std::memory_order_relaxed) != hash) {
+                    continue;
+                }
+                auto* node = reinterpret_cast<Node*>(entry);
+                if (node->hash == hash && equal(key, node->key)) {
+                    return node;
+                }
+            }
+        }
+
+        // 写者：返回 node 所在的槽位
+        Slot* slot_of(Table* t, const Node* node) const noexcept {
+            for (size_t i = mix(node->hash) & t->mask;; i = (i + 1) & t->mask) {
+                uintptr_t entry = t->slots[i].entry.load(std::memory_order_relaxed);
+                if (entry == reinterpret_cast<uintptr_t>(node)) {
+                    return &t->slots[i];
+                }
+                if (entry == 0) {
+                    return nullptr;
+                }
+            }
+        }
+
+        // 写者：放入一个表中还没有的键
+        static void place(Table* t, Node* node) noexcept {
+            for (size_t i = mix(node->hash) & t->mask;; i = (i + 1) & t->mask) {
+                Slot& slot = t->slots[i];
+                uintptr_t entry = slot.entry.load(std::memory_order_relaxed);
+                if (entry == 0 || entry == kTombstone) {
+                    if (entry == 0) {
+                        ++t->used;
+                    }
+                    slot.hash.store(node->hash, std::memory_order_relaxed);
+                    slot.entry.store(reinterpret_cast<uintptr_t>(node), std::memory_order_release);
+                    return;
+                }
+            }
+        }
+
+        // 写者：装载过高时换用新表（清除墓碑），旧表按纪元延迟释放
+        void grow_if_needed() {
+            Table* t = table.load(std::memory_order_relaxed);
+            if ((t->used + 1) * 2 <= t->mask + 1) {
+                return;
+            }
+            auto fresh = std::make_unique<Table>(table_size_for(count + 1));
+            for (size_t i = 0; i <= t->mask; ++i) {
+                uintptr_t entry = t->slots[i].entry.load(std::memory_order_relaxed);
+                if (entry != 0 && entry != kTombstone) {
+                    place(fresh.get(), reinterpret_cast<Node*>(entry));
+                }
+            }
+            retired.push_back({domain.current(), nullptr, t});
+            table.store(fresh.release(), std::memory_order_release);
+        }
+
+        // 写者：从表和策略中摘下节点，节点本身按纪元延迟回收
+        void unlink(Node* node, bool evicted) {
+            retired.push_back({domain.current(), node, nullptr});
+            if (Slot* slot = slot_of(table.load(std::memory_order_relaxed), node)) {
+                slot->entry.store(kTombstone, std::memory_order_release);
+            }
+            --count;
+            policy.remove(node, evicted);
+        }
+
+        // 读者：记录一次命中，缓冲已满时丢弃；返回是否需要维护：缓冲已满，
+        // 或者有对象等待回收且本条带又记录了 kBufferSize 次访问
+        bool record_access(size_t hash) noexcept {
+            ReadBuffer& buffer = buffers[detail::thread_stripe() & (EpochDomain::kStripes - 1)];
+            uint64_t w = buffer.writes.load(std::memory_order_relaxed);
+            if (w - buffer.reads.load(std::memory_order_relaxed) >= kBufferSize) {
+                return true;
+            }
+            if (!buffer.writes.compare_exchange_strong(w, w + 1, std::memory_order_relaxed)) {
+                return false;  // 与同条带的其他线程竞争失败，丢弃这次记录
+            }
+            buffer.entries[w & (kBufferSize - 1)].store(hash == 0 ? 1 : hash, std::memory_order_release);
+            return (w & (kBufferSize - 1)) == kBufferSize - 1 && reclaimPending.load(std::memory_order_relaxed);
+        }
+
+        // 写者：把访问缓冲回放给策略；只凭哈希找节点，碰撞时提升的可能是别的条目
+        void drain_buffers() {
+            const Table* t = table.load(std::memory_order_relaxed);
+            for (auto& buffer : buffers) {
+                uint64_t end = buffer.writes.load(std::memory_order_acquire);
+                uint64_t begin = buffer.reads.load(std::memory_order_relaxed);
+                for (uint64_t i = begin; i < end; ++i) {
+                    size_t hash = buffer.entries[i & (kBufferSize - 1)].exchange(0, std::memory_order_acquire);
+                    if (hash == 0) {
+                        continue;  // 读者已占位但还没写入
+                    }
+                    for (size_t j = mix(hash) & t->mask;; j = (j + 1) & t->mask) {
+                        uintptr_t entry = t->slots[j].entry.load(std::memory_order_relaxed);
+                        if (entry == 0) {
+                            break;
+                        }
+                        if (entry != kTombstone && t->slots[j].hash.load(std::memory_order_relaxed) == hash) {
+                            policy.access(reinterpret_cast<Node*>(entry));
+                            break;
+                        }
+                    }
+                }
+                buffer.reads.store(end, std::memory_order_relaxed);
+            }
+        }
+
+        // 写者：扫描全部条带的开销较大，写操作每隔 kMaintainInterval 次才维护一次
+        void after_write() {
+            if (++writesSinceMaintain >= kMaintainInterval || retired.size() >= kMaxRetired) {
+                maintain_locked();
+            } else {
+                reclaimPending.store(!retired.empty(), std::memory_order_relaxed);
+            }
+        }
+
+        // 写者：推进纪元，回放访问缓冲，释放已经没有读者能看到的节点和旧表
+        void maintain_locked() {
+            writesSinceMaintain = 0;
+            // 对象在纪元 e 摘下，纪元到达 e + 2 才能释放：连续尝试推进两次
+            if (!retired.empty() && domain.try_advance()) {
+                domain.try_advance();
+            }
+            drain_buffers();
+            auto keep = std::partition(retired.begin(), retired.end(), [this](const Retired& r) {
+                return !domain.safe_to_free(r.epoch);
+            });
+            for (auto it = keep; it != retired.end(); ++it) {
+                if (it->node) {
+                    unref(it->node);
+                } else {
+                    delete it->table;
+                }
+            }
+            retired.erase(keep, retired.end());
+            reclaimPending.store(!retired.empty(), std::memory_order_relaxed);
+        }
+
+        template<typename K>
+        Handle lookup(const K& key) {
+            const size_t hash = hasher(key);
+            Node* node;
+            bool needsMaintenance;
+            {
+                EpochDomain::Guard guard(domain);
+                node = find_in(table.load(std::memory_order_acquire), hash, key);
+                if (!node) {
+                    return Handle();
+                }
+                // 纪元内节点不会被释放，缓存自己的引用也还在，直接加 1 即可
+                node->refs.fetch_add(1, std::memory_order_relaxed);
+                needsMaintenance = record_access(hash);
+            }
+            if (needsMaintenance && writeMutex.try_lock()) {
+                std::lock_guard<std::mutex> guard(writeMutex, std::adopt_lock);
+                maintain_locked();
+            }
+            return Handle(node);
+        }
+
+        template<typename K>
+        bool contains_key(const K& key) const {
+            EpochDomain::Guard guard(domain);
+            return find_in(table.load(std::memory_order_acquire), hasher(key), key) != nullptr;
+        }
+
+        template<typename K>
+        bool erase_key(const K& key) {
+            std::lock_guard<std::mutex> guard(writeMutex);
+            Node* node = find_in(table.load(std::memory_order_relaxed), hasher(key), key);
+            if (node) {
+                unlink(node, false);
+            }
+            after_write();
+            return node != nullptr;
+        }
+
+    public:
+        explicit ConcurrentLRUCache(size_t capacity)
+            : table(new Table(table_size_for(capacity))), policy(capacity), maxSize(capacity) {}
+
+        ConcurrentLRUCache(const ConcurrentLRUCache&) = delete;
+        ConcurrentLRUCache& operator=(const ConcurrentLRUCache&) = delete;
+
+        // 析构时不能再有并发的读者
+        ~ConcurrentLRUCache() {
+            Table* t = table.load(std::memory_order_relaxed);
+            for (size_t i = 0; i <= t->mask; ++i) {
+                uintptr_t entry = t->slots[i].entry.load(std::memory_order_relaxed);
+                if (entry != 0 && entry != kTombstone) {
+                    unref(reinterpret_cast<Node*>(entry));
+                }
+            }
+            delete t;
+            for (const auto& r : retired) {
+                if (r.node) {
+                    unref(r.node);
+                } else {
+                    delete r.table;
+                }
+            }
+        }
+
+        // 节点在锁外构造；已存在的键原地换入新节点
+        template<typename K, typename V>
+        void put(K&& key, V&& value) {
+            Key k(std::forward<K>(key));
+            size_t hash = hasher(k);
+            auto node = std::make_unique<Node>(hash, std::move(k), std::forward<V>(value));
+
+            std::lock_guard<std::mutex> guard(writeMutex);
+            Table* t = table.load(std::memory_order_relaxed);
+            if (Node* old = find_in(t, hash, node->key)) {
+                retired.push_back({domain.current(), old, nullptr});
+                policy.replace(old, node.get());
+                slot_of(t, old)->entry.store(reinterpret_cast<uintptr_t>(node.release()),
+                                             std::memory_order_release);
+            } else {
+                while (count >= maxSize) {
+                    Node* victim = policy.victim();
+                    if (!victim) {
+                        break;
+                    }
+                    unlink(victim, true);
+                }
+                grow_if_needed();
+                policy.insert(node.get());
+                place(table.load(std::memory_order_relaxed), node.release());
+                ++count;
+            }
+            after_write();
+        }
+
+        Handle get(const Key& key) { return lookup(key); }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        Handle get(const K& key) { return lookup(key); }
+
+        bool contains(const Key& key) const { return contains_key(key); }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        bool contains(const K& key) const { return contains_key(key); }
+
+        bool erase(const Key& key) { return erase_key(key); }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        bool erase(const K& key) { return erase_key(key); }
+
+        void clear() {
+            std::lock_guard<std::mutex> guard(writeMutex);
+            Table* t = table.load(std::memory_order_relaxed);
+            for (size_t i = 0; i <= t->mask; ++i) {
+                uintptr_t entry = t->slots[i].entry.load(std::memory_order_relaxed);
+                if (entry != 0 && entry != kTombstone) {
+                    unlink(reinterpret_cast<Node*>(entry), false);
+                }
+            }
+            maintain_locked();
+        }
+
+        // 回放访问缓冲并回收可以释放的节点；写操作会定期调用，空闲时也可以手动调用
+        void maintain() {
+            std::lock_guard<std::mutex> guard(writeMutex);
+            maintain_locked();
+        }
+
+        void print_cache() const {
+            std::lock_guard<std::mutex> guard(writeMutex);
+            std::cout << "缓存内容 (按淘汰顺序，近似): ";
+            policy.for_each([](const Node& node) {
+                std::cout << "[" << node.key << "] ";
+            });
+            std::cout << "\n";
+        }
+
+        size_t size() const {
+            std::lock_guard<std::mutex> guard(writeMutex);
+            return count;
+        }
+
+        // 已摘下但还在等待读者离开的节点和旧表数
+        size_t pending_reclamation() const {
+            std::lock_guard<std::mutex> guard(writeMutex);
+            return retired.size();
+        }
+
+        size_t capacity() const { return maxSize; }
+    };
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "cache_system/thread_stripe.hpp"
+
+/**
+ * 基于纪元 (epoch) 的内存回收 - ConcurrentLRUCache 无锁读路径的安全保证
+ *
+ * 读者在访问共享结构前进入当前纪元，离开时退出；写者把摘下的对象连同
+ * 摘下时的纪元 r 记入待回收列表，全局纪元推进到 r + 2 后才真正释放。
+ * 纪元从 e 推进到 e + 1 的前提是没有读者还停留在 e - 1，因此到达 r + 2 时
+ * 所有可能看到该对象的读者（进入纪元不晚于 r）都已离开。
+ *
+ * 读者不登记到每线程的记录里，而是按线程分配到 64 个条带之一，每个条带
+ * 对奇偶两个纪元各有一个计数器并独占一条缓存行。不同线程落在不同条带上，
+ * 进入/退出只修改本线程的缓存行，不会在读者之间来回传递缓存行。
+ * 写者推进纪元时扫描全部条带，只应在持有写锁时调用（单写者）。
+ */
+namespace CacheSystem {
+
+    class EpochDomain {
+    public:
+        static constexpr size_t kStripes = 64;
+
+    private:
+        struct alignas(64) Stripe {
+            std::atomic<uint64_t> active[2] = {0, 0};  // 按纪元奇偶分别计数
+        };
+
+        alignas(64) std::atomic<uint64_t> epoch{0};
+        Stripe stripes[kStripes];
+
+    public:
+        // 读者在作用域内停留在进入时的纪元
+        class Guard {
+        private:
+            std::atomic<uint64_t>* counter;
+
+        public:
+            explicit Guard(EpochDomain& domain) noexcept {
+                Stripe& stripe = domain.stripes[detail::thread_stripe() & (kStripes - 1)];
+                for (;;) {
+                    uint64_t e = domain.epoch.load(std::memory_order_seq_cst);
+                    counter = &stripe.active[e & 1];
+                    counter->fetch_add(1, std::memory_order_seq_cst);
+                    // 登记之后纪元没有变化，写者推进时一定能看到这次登记
+                    if (domain.epoch.load(std::memory_order_seq_cst) == e) {
+                        return;
+                    }
+                    counter->fetch_sub(1, std::memory_order_release);
+                }
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+            ~Guard() { counter->fetch_sub(1, std::memory_order_release); }
+        };
+
+        EpochDomain() = default;
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        uint64_t current() const noexcept { return epoch.load(std::memory_order_seq_cst); }
+
+        // 上一个纪元已经没有读者时推进一步，返回是否推进（只由写者调用）
+        bool try_advance() noexcept {
+            const uint64_t e = epoch.load(std::memory_order_relaxed);
+            for (const auto& stripe : stripes) {
+                if (stripe.active[(e + 1) & 1].load(std::memory_order_seq_cst) != 0) {
+                    return false;
+                }
+            }
+            epoch.store(e + 1, std::memory_order_seq_cst);
+            return true;
+        }
+
+        // 在纪元 retiredAt 摘下的对象现在是否可以释放
+        bool safe_to_free(uint64_t retiredAt) const noexcept { return current() >= retiredAt + 2; }
+    };
+
+}
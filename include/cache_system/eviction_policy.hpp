@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+/**
+ * 淘汰策略
+ *
+ * LRUCache 把"记录访问、挑选淘汰对象"委托给策略模板 Policy<Node>。
+ * 所有策略都以侵入方式把元数据保存在节点的 PolicyHook 中，不额外分配内存
+ * （ARC 的幽灵列表除外）。策略的所有方法都在缓存的锁内调用：
+ *
+ *   insert(node)          新条目进入缓存
+ *   access(node)          命中未被钉住的条目
+ *   replace(old, node)    同一个键换入新节点，新节点继承旧节点的位置/分段
+ *   pin(node)             条目被 Handle 钉住，暂时退出淘汰候选
+ *   unpin(node)           最后一个 Handle 释放，重新成为淘汰候选
+ *   remove(node, evicted) 条目离开缓存；evicted 表示由容量淘汰触发
+ *   victim(skip)          下一个淘汰对象（不移除），跳过 skip（正在放入的节点）；
+ *                         没有候选时返回 nullptr
+ *   for_each(f)           按大致的淘汰顺序（最冷的在前）遍历候选条目
+ *
+ * 容量与节点权重 (charge) 使用相同的单位，分段大小按权重计算。
+ */
+namespace CacheSystem {
+
+    namespace detail {
+
+        // 侵入式双向链表挂钩，哨兵节点首尾相连
+        struct ListHook {
+            ListHook* prev = this;
+            ListHook* next = this;
+
+            bool linked() const noexcept { return next != this; }
+
+            void unlink() noexcept {
+                prev->next = next;
+                next->prev = prev;
+                prev = next = this;
+            }
+
+            // 将 hook 插入到 this 之后
+            void push_after(ListHook* hook) noexcept {
+                hook->prev = this;
+                hook->next = next;
+                next->prev = hook;
+                next = hook;
+            }
+        };
+
+        // 链表 list 中最旧的条目（prev 方向），跳过 skip；没有时返回 nullptr
+        inline ListHook* oldest(ListHook& list, const ListHook* skip) noexcept {
+            ListHook* hook = list.prev;
+            if (hook == skip) {
+                hook = hook->prev;
+            }
+            return hook != &list ? hook : nullptr;
+        }
+
+        // 策略使用的节点元数据
+        struct PolicyHook : ListHook {
+            size_t hash = 0;
+            size_t charge = 1;        // 条目权重
+            uint8_t segment = 0;      // SLRU/ARC 所在分段
+            bool referenced = false;  // CLOCK 访问位
+            bool pinned = false;      // CLOCK 中被钉住的条目留在环上，但不会被选中
+        };
+
+    }
+
+    /**
+     * 严格 LRU：每次命中都移动到链表头部（默认策略）
+     */
+    template<typename Node>
+    class LRUPolicy {
+    private:
+        detail::ListHook list;  // next 指向最近使用，prev 指向最久未使用
+
+    public:
+        explicit LRUPolicy(size_t) {}
+
+        void insert(Node* node) noexcept { list.push_after(node); }
+
+        void access(Node* node) noexcept {
+            node->unlink();
+            list.push_after(node);
+        }
+
+        void replace(Node* old, Node* node) noexcept {
+            old->unlink();
+            list.push_after(node);
+        }
+
+        void pin(Node* node) noexcept { node->unlink(); }
+        void unpin(Node* node) noexcept { list.push_after(node); }
+        void remove(Node* node, bool) noexcept { node->unlink(); }
+
+        Node* victim(const Node* skip = nullptr) noexcept {
+            return static_cast<Node*>(detail::oldest(list, skip));
+        }
+
+        template<typename F>
+        void for_each(F&& f) const {
+            for (auto* hook = list.prev; hook != &list; hook = hook->prev) {
+                f(*static_cast<const Node*>(hook));
+            }
+        }
+    };
+
+    /**
+     * CLOCK（二次机会）：命中只设置访问位，不移动链表
+     * 时钟指针扫过带访问位的条目时清除访问位，遇到未访问的条目即淘汰
+     * 钉住/释放也只修改标志位，因此读路径上完全没有链表操作
+     */
+    template<typename Node>
+    class ClockPolicy {
+    private:
+        detail::ListHook ring;
+        detail::ListHook* hand = &ring;
+        size_t count = 0;
+
+        void advance() noexcept {
+            hand = hand->next;
+            if (hand == &ring) {
+                hand = ring.next;
+            }
+        }
+
+        // 插入到指针之后被扫描到的最后一个位置
+        void link_behind_hand(Node* node) noexcept {
+            hand->prev->push_after(node);
+        }
+
+        void unlink(Node* node) noexcept {
+            if (!node->linked()) {
+                return;
+            }
+            if (hand == node) {
+                advance();
+                if (hand == node) {
+                    hand = &ring;
+                }
+            }
+            node->unlink();
+            node->pinned = false;
+            --count;
+        }
+
+    public:
+        explicit ClockPolicy(size_t) {}
+
+        void insert(Node* node) noexcept {
+            node->referenced = false;
+            link_behind_hand(node);
+            ++count;
+        }
+
+        void access(Node* node) noexcept { node->referenced = true; }
+
+        void replace(Node* old, Node* node) noexcept {
+            node->referenced = true;
+            old->prev->push_after(node);
+            ++count;
+            unlink(old);
+        }
+
+        void pin(Node* node) noexcept { node->pinned = true; }
+
+        void unpin(Node* node) noexcept {
+            node->pinned = false;
+            node->referenced = true;
+        }
+
+        void remove(Node* node, bool) noexcept { unlink(node); }
+
+        Node* victim(const Node* skip = nullptr) noexcept {
+            if (!ring.linked()) {
+                return nullptr;
+            }
+            if (hand == &ring) {
+                hand = ring.next;
+            }
+            // 最多转两圈：第一圈清除所有访问位；全部被钉住时没有候选
+            for (size_t step = 0; step <= 2 * count; ++step) {
+                auto* node = static_cast<Node*>(hand);
+                if (!node->pinned && node != skip) {
+                    if (!node->referenced) {
+                        return node;
+                    }
+                    node->referenced = false;
+                }
+                advance();
+            }
+            return nullptr;
+        }
+
+        template<typename F>
+        void for_each(F&& f) const {
+            if (!ring.linked()) {
+                return;
+            }
+            const detail::ListHook* start = hand == &ring ? ring.next : hand;
+            const detail::ListHook* hook = start;
+            do {
+                if (!static_cast<const Node*>(hook)->pinned) {
+                    f(*static_cast<const Node*>(hook));
+                }
+                hook = hook->next == &ring ? ring.next : hook->next;
+            } while (hook != start);
+        }
+    };
+
+    /**
+     * 分段 LRU：新条目进入试用段，再次命中晋升到保护段
+     * 保护段占容量的 80%，溢出时把保护段最旧的条目降级回试用段；
+     * 优先淘汰试用段，一次性扫描不会冲掉保护段中的热点
+     */
+    template<typename Node>
+    class SegmentedLRUPolicy {
+    private:
+        enum : uint8_t { kProbation = 0, kProtected = 1 };
+
+        detail::ListHook probation;
+        detail::ListHook protectedList;
+        size_t protectedCapacity;
+        size_t protectedUsage = 0;
+
+        void link(Node* node) noexcept {
+            if (node->segment == kProtected) {
+                protectedList.push_after(node);
+                protectedUsage += node->charge;
+                while (protectedUsage > protectedCapacity && protectedList.prev != node) {
+                    auto* demoted = static_cast<Node*>(protectedList.prev);
+                    unlink(demoted);
+                    demoted->segment = kProbation;
+                    probation.push_after(demoted);
+                }
+            } else {
+                probation.push_after(node);
+            }
+        }
+
+        void unlink(Node* node) noexcept {
+            if (!node->linked()) {
+                return;
+            }
+            if (node->segment == kProtected) {
+                protectedUsage -= node->charge;
+            }
+            node->unlink();
+        }
+
+    public:
+        explicit SegmentedLRUPolicy(size_t capacity)
+            : protectedCapacity(capacity - capacity / 5) {}
+
+        void insert(Node* node) noexcept {
+            node->segment = kProbation;
+            link(node);
+        }
+
+        void access(Node* node) noexcept {
+            unlink(node);
+            node->segment = kProtected;
+            link(node);
+        }
+
+        void replace(Node* old, Node* node) noexcept {
+            unlink(old);
+            node->segment = kProtected;
+            link(node);
+        }
+
+        void pin(Node* node) noexcept { unlink(node); }
+        void unpin(Node* node) noexcept { link(node); }
+        void remove(Node* node, bool) noexcept { unlink(node); }
+
+        Node* victim(const Node* skip = nullptr) noexcept {
+            if (auto* hook = detail::oldest(probation, skip)) {
+                return static_cast<Node*>(hook);
+            }
+            return static_cast<Node*>(detail::oldest(protectedList, skip));
+        }
+
+        template<typename F>
+        void for_each(F&& f) const {
+            for (auto* hook = probation.prev; hook != &probation; hook = hook->prev) {
+                f(*static_cast<const Node*>(hook));
+            }
+            for (auto* hook = protectedList.prev; hook != &protectedList; hook = hook->prev) {
+                f(*static_cast<const Node*>(hook));
+            }
+        }
+    };
+
+    /**
+     * ARC (Adaptive Replacement Cache)
+     *
+     * T1 保存只访问过一次的条目，T2 保存访问过多次的条目；
+     * B1/B2 是它们被淘汰条目的"幽灵"（只记录哈希值和权重）。
+     * 在 B1 中再次出现说明应给 T1 更多空间（增大目标 p），在 B2 中出现则相反。
+     *
+     * 与论文的差异：p 和各列表大小按权重计算；淘汰时不区分新键是否在 B2 中；
+     * 被钉住的条目暂时不计入 T1/T2。幽灵记录在淘汰时分配，内存不足时丢弃该记录
+     * （容量按权重计时条目数没有上界，无法按容量预先分配）。
+     */
+    template<typename Node>
+    class ARCPolicy {
+    private:
+        enum : uint8_t { kT1 = 0, kT2 = 1 };
+
+        struct Ghost {
+            size_t hash;
+            size_t charge;
+        };
+
+        struct GhostList {
+            std::list<Ghost> order;  // front 为最近淘汰
+            std::unordered_map<size_t, typename std::list<Ghost>::iterator> lookup;
+            size_t usage = 0;
+
+            bool take(size_t hash) {
+                auto it = lookup.find(hash);
+                if (it == lookup.end()) {
+                    return false;
+                }
+                usage -= it->second->charge;
+                order.erase(it->second);
+                lookup.erase(it);
+                return true;
+            }
+
+            // 分配失败时抛出 std::bad_alloc，列表保持不变
+            void push(size_t hash, size_t charge) {
+                take(hash);
+                order.push_front({hash, charge});
+                try {
+                    lookup[hash] = order.begin();
+                } catch (...) {
+                    order.pop_front();
+                    throw;
+                }
+                usage += charge;
+            }
+
+            void pop_oldest() noexcept {
+                usage -= order.back().charge;
+                lookup.erase(order.back().hash);
+                order.pop_back();
+            }
+        };
+
+        detail::ListHook t1;
+        detail::ListHook t2;
+        size_t t1Usage = 0;
+        size_t t2Usage = 0;
+        GhostList b1;
+        GhostList b2;
+        size_t capacity;
+        size_t target = 0;  // T1 的目标大小 p
+
+        void link(Node* node) noexcept {
+            if (node->segment == kT2) {
+                t2.push_after(node);
+                t2Usage += node->charge;
+            } else {
+                t1.push_after(node);
+                t1Usage += node->charge;
+            }
+        }
+
+        void unlink(Node* node) noexcept {
+            if (!node->linked()) {
+                return;
+            }
+            (node->segment == kT2 ? t2Usage : t1Usage) -= node->charge;
+            node->unlink();
+        }
+
+        // 幽灵列表的大小约束：|T1|+|B1| <= c，|T1|+|T2|+|B1|+|B2| <= 2c
+        void trim_ghosts() noexcept {
+            while (!b1.order.empty() && t1Usage + b1.usage > capacity) {
+                b1.pop_oldest();
+            }
+            while (!b2.order.empty() && t1Usage + t2Usage + b1.usage + b2.usage > 2 * capacity) {
+                b2.pop_oldest();
+            }
+        }
+
+    public:
+        explicit ARCPolicy(size_t c) : capacity(c) {}
+
+        void insert(Node* node) {
+            if (b1.lookup.count(node->hash)) {
+                size_t delta = std::max<size_t>(b1.usage ? b2.usage / b1.usage : 1, 1) * node->charge;
+                target = std::min(capacity, target + delta);
+                b1.take(node->hash);
+                node->segment = kT2;
+            } else if (b2.lookup.count(node->hash)) {
+                size_t delta = std::max<size_t>(b2.usage ? b1.usage / b2.usage : 1, 1) * node->charge;
+                target = target > delta ? target - delta : 0;
+                b2.take(node->hash);
+                node->segment = kT2;
+            } else {
+                node->segment = kT1;
+            }
+            link(node);
+            trim_ghosts();
+        }
+
+        void access(Node* node) noexcept {
+            unlink(node);
+            node->segment = kT2;
+            link(node);
+        }
+
+        void replace(Node* old, Node* node) noexcept {
+            unlink(old);
+            node->segment = kT2;
+            link(node);
+        }
+
+        void pin(Node* node) noexcept { unlink(node); }
+        void unpin(Node* node) noexcept { link(node); }
+
+        // 在缓存的 noexcept 淘汰路径上调用：记录幽灵时内存不足就放弃这一条记录，
+        // 只会让目标 p 少一次调整
+        void remove(Node* node, bool evicted) noexcept {
+            bool wasLinked = node->linked();
+            unlink(node);
+            if (evicted && wasLinked) {
+                try {
+                    (node->segment == kT2 ? b2 : b1).push(node->hash, node->charge);
+                } catch (...) {
+                }
+                trim_ghosts();
+            }
+        }
+
+        Node* victim(const Node* skip = nullptr) noexcept {
+            bool fromT1 = t1.linked() && (t1Usage > target || !t2.linked());
+            auto* first = detail::oldest(fromT1 ? t1 : t2, skip);
+            return static_cast<Node*>(first ? first : detail::oldest(fromT1 ? t2 : t1, skip));
+        }
+
+        template<typename F>
+        void for_each(F&& f) const {
+            for (auto* hook = t1.prev; hook != &t1; hook = hook->prev) {
+                f(*static_cast<const Node*>(hook));
+            }
+            for (auto* hook = t2.prev; hook != &t2; hook = hook->prev) {
+                f(*static_cast<const Node*>(hook));
+            }
+        }
+    };
+
+}
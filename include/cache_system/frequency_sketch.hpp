@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * 频率草图 (Count-Min Sketch) - TinyLFU 准入过滤器的计数器
+ *
+ * 4 位饱和计数器，每个 uint64_t 存 16 个；每个键通过 4 个独立的哈希位置计数，
+ * 估计值取 4 个计数器的最小值。计数器总数为预期条目数向上取整到 2 的幂再乘 2，
+ * 即每个条目约 1 字节。
+ *
+ * 老化：累计增加次数达到 10 倍预期条目数时，所有计数器减半，
+ * 使频率反映最近一段时间的访问而不是全部历史。
+ */
+namespace CacheSystem {
+
+    class FrequencySketch {
+    private:
+        static constexpr uint64_t kResetMask = 0x7777777777777777ULL;
+        static constexpr uint64_t kSeeds[4] = {
+            0x97cb3127ULL, 0xab8a2c4fULL, 0xc2b2ae3dULL, 0x27d4eb2fULL};
+
+        std::vector<uint64_t> table;
+        size_t counterMask = 0;
+        size_t additions = 0;
+        size_t sampleSize = 0;
+
+        static uint64_t rehash(uint64_t hash, uint64_t seed) noexcept {
+            uint64_t h = (hash + seed) * 0x9e3779b97f4a7c15ULL;
+            return h ^ (h >> 32);
+        }
+
+        uint8_t counter_at(size_t index) const noexcept {
+            return static_cast<uint8_t>((table[index >> 4] >> ((index & 15) << 2)) & 0xf);
+        }
+
+        // 计数器未饱和时加 1，返回是否真的增加了
+        bool increment_at(size_t index) noexcept {
+            uint64_t& word = table[index >> 4];
+            unsigned shift = static_cast<unsigned>((index & 15) << 2);
+            if (((word >> shift) & 0xf) == 0xf) {
+                return false;
+            }
+            word += 1ULL << shift;
+            return true;
+        }
+
+        void reset() noexcept {
+            for (auto& word : table) {
+                word = (word >> 1) & kResetMask;
+            }
+            additions /= 2;
+        }
+
+    public:
+        explicit FrequencySketch(size_t expectedEntries) {
+            size_t counters = 16;
+            while (counters < std::max<size_t>(expectedEntries, 1) * 2) {
+                counters <<= 1;
+            }
+            table.assign(counters / 16, 0);
+            counterMask = counters - 1;
+            sampleSize = std::max<size_t>(expectedEntries, 1) * 10;
+        }
+
+        size_t frequency(size_t hash) const noexcept {
+            uint8_t result = 0xf;
+            for (uint64_t seed : kSeeds) {
+                result = std::min(result, counter_at(rehash(hash, seed) & counterMask));
+            }
+            return result;
+        }
+
+        void increment(size_t hash) noexcept {
+            bool added = false;
+            for (uint64_t seed : kSeeds) {
+                added |= increment_at(rehash(hash, seed) & counterMask);
+            }
+            if (added && ++additions >= sampleSize) {
+                reset();
+            }
+        }
+
+        // 计数器占用的字节数
+        size_t memory_usage() const noexcept { return table.size() * sizeof(uint64_t); }
+    };
+
+}
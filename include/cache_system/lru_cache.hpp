@@ -0,0 +1,1058 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cache_system/cache_stats.hpp"
+#include "cache_system/eviction_policy.hpp"
+#include "cache_system/frequency_sketch.hpp"
+#include "cache_system/negative_filter.hpp"
+#include "cache_system/node_slab.hpp"
+#include "cache_system/snapshot.hpp"
+#include "cache_system/swiss_index.hpp"
+#include "cache_system/timer_wheel.hpp"
+
+/**
+ * LRU 缓存 - 哈希索引 + 侵入式最近使用链表
+ *
+ * 设计要点：
+ * 1. 每个条目是一个节点，从 NodeSlab 成块分配的连续内存中切出，
+ *    节点地址在整个生命周期内不变，查找、提升、淘汰都只改动指针，
+ *    存储的值从不被移动
+ * 2. 索引是以节点指针为元素的 SwissIndex（开放寻址，SIMD 比较 1 字节标签），
+ *    键只在节点中存一份，直接用 Key 查找节点；Hash 与 KeyEqual 都透明时
+ *    （std::string 键的默认配置），get/contains/erase 可以直接接受
+ *    std::string_view 或 const char*，只有插入时才构造 Key
+ * 3. 访问记录与淘汰对象的选择委托给 Policy 模板参数（见 eviction_policy.hpp），
+ *    默认是严格 LRU，也可选 CLOCK、分段 LRU 和 ARC，接口完全相同；
+ *    所有策略的查找、提升、淘汰均为 O(1)
+ * 4. get 返回引用计数的 Handle，命中时零拷贝；持有 Handle 的条目被"钉住"，
+ *    退出淘汰候选，不会被容量淘汰
+ * 5. Lock 参数默认为空锁；传入 std::mutex 即得到线程安全的版本
+ *    （ShardedLRUCache 的每个分片），节点的构造与销毁都在锁外进行
+ * 6. 容量以"权重"计量：默认每个条目权重为 1（即条目数）；传入 Weigher
+ *    后可按字节等单位计量，插入时持续淘汰最久未使用的条目直到新条目放得下
+ * 7. 可选的 TinyLFU 准入过滤：缓存已满时，只有新键的估计访问频率高于
+ *    淘汰对象时才接纳它，避免只出现一次的键冲掉有价值的条目
+ * 8. 可选的 TTL：每个条目可以有自己的存活时间，或使用默认 TTL。
+ *    过期条目在访问时惰性移除，并由 tick() 通过分层时间轮主动清理
+ * 9. get_or_compute 合并并发未命中：同一个键同时只有一个调用者在锁外运行
+ *    加载函数，其余调用者等待它的结果；加载失败时异常传给所有等待者，
+ *    缓存中不留下任何条目
+ * 10. multi_get / multi_put 批量操作：在锁外计算全部哈希（或构造全部节点），
+ *    整批只加锁一次；release_batch 同样一次加锁释放一批 Handle
+ * 11. save_snapshot / load_snapshot 把缓存内容按最近使用顺序写入二进制文件
+ *    并在重启后读回（格式见 snapshot.hpp），避免部署后的冷启动；
+ *    保存时只在钉住条目期间持有锁，文件写完后原子地替换原来的快照
+ * 12. 淘汰监听器：被容量淘汰或过期移除的条目在销毁前（锁外）把键和值以右值
+ *    交给监听器，例如用 recycle_into 把值的缓冲区交还给 BufferPool 复用
+ * 13. 不逐操作打印日志；命中、未命中、插入、更新、淘汰计数与 get/put 的
+ *    采样延迟直方图记录在按线程分条带的原子计数器中，由 stats() 汇总
+ * 14. 可选的否定查找缓存：get_or_load 的加载函数返回 std::nullopt 表示键不存在，
+ *    这些键记入分块布隆过滤器（见 negative_filter.hpp），之后的查找在调用加载函数
+ *    之前就返回未命中；键被插入时从过滤器中失效
+ *
+ * 节点引用计数：缓存本身持有 1 个引用，每个 Handle 再持有 1 个。
+ * 被 erase 或被新值替换的节点会立即从索引中移除，但直到最后一个 Handle
+ * 释放才真正销毁，因此 Handle 看到的值始终不可变。
+ * Handle 不能比创建它的缓存活得更久。
+ */
+namespace CacheSystem {
+
+    namespace detail {
+
+        // std::string 键的透明哈希：string_view / const char* 查找时不构造 std::string
+        struct StringHash {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view s) const noexcept {
+                return std::hash<std::string_view>{}(s);
+            }
+        };
+
+        template<typename Key>
+        struct DefaultLookup {
+            using Hash = std::hash<Key>;
+            using KeyEqual = std::equal_to<Key>;
+        };
+
+        template<>
+        struct DefaultLookup<std::string> {
+            using Hash = StringHash;
+            using KeyEqual = std::equal_to<>;
+        };
+
+        // K 可以不经转换直接用于查找：哈希与比较器都透明且都接受 K
+        template<typename K, typename Key, typename Hash, typename KeyEqual>
+        concept heterogeneous_key =
+            !std::is_same_v<std::remove_cvref_t<K>, Key> &&
+            requires(const Hash& hash, const KeyEqual& equal, const K& k, const Key& key) {
+                typename Hash::is_transparent;
+                typename KeyEqual::is_transparent;
+                { hash(k) } -> std::convertible_to<size_t>;
+                { equal(k, key) } -> std::convertible_to<bool>;
+                { equal(key, k) } -> std::convertible_to<bool>;
+            };
+
+        // 批量查找中预先算好哈希的键，slot 为结果在输出中的位置
+        template<typename Key>
+        struct HashedKey {
+            const Key* key;
+            size_t hash;
+            size_t slot;
+        };
+
+        // 预取提示：批量操作在处理前先把即将访问的节点拉进缓存
+        inline void prefetch(const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address, 1, 3);
+#else
+            (void)address;
+#endif
+        }
+
+        template<typename T>
+        struct is_optional : std::false_type {};
+
+        template<typename T>
+        struct is_optional<std::optional<T>> : std::true_type {};
+
+        // 单线程使用时的空锁，满足 BasicLockable
+        struct NullLock {
+            void lock() noexcept {}
+            void unlock() noexcept {}
+        };
+
+    }
+
+    template<typename Key, typename Value,
+             template<typename> class Policy = LRUPolicy,
+             typename Hash = typename detail::DefaultLookup<Key>::Hash,
+             typename KeyEqual = typename detail::DefaultLookup<Key>::KeyEqual,
+             typename Lock = detail::NullLock>
+    class LRUCache;
+
+    template<typename Key, typename Value, template<typename> class Policy,
+             typename Hash, typename KeyEqual>
+    class ShardedLRUCache;
+
+    template<typename Key, typename Value,
+             template<typename> class Policy,
+             typename Hash, typename KeyEqual, typename Lock>
+    class LRUCache {
+        // 分片缓存在各分片上直接调用批量操作的内部入口
+        template<typename, typename, template<typename> class, typename, typename>
+        friend class ShardedLRUCache;
+
+    private:
+        // hash 与 charge（权重，插入前由 Weigher 计算）位于 PolicyHook 中，
+        // 到期时间位于 TimerHook 中
+        struct CacheNode : detail::PolicyHook, detail::TimerHook {
+            Key key;
+            Value value;
+            uint32_t refs = 1;     // 缓存持有的引用
+            bool inCache = true;   // 是否仍在索引中
+            bool notify = false;   // 被淘汰或过期移除，销毁前交给淘汰监听器
+
+            template<typename K, typename V>
+            CacheNode(size_t h, K&& k, V&& v)
+                : key(std::forward<K>(k)), value(std::forward<V>(v)) {
+                hash = h;
+            }
+        };
+
+        using NodeSlabType = NodeSlab<CacheNode, Lock>;
+
+        // 批量路径中在锁外持有尚未放入缓存的节点，析构时归还给 slab
+        struct NodeDeleter {
+            NodeSlabType* slab = nullptr;
+
+            void operator()(CacheNode* node) const noexcept { slab->destroy(node); }
+        };
+        using NodePtr = std::unique_ptr<CacheNode, NodeDeleter>;
+
+    public:
+        // load_snapshot 每次加锁插入的条目数
+        static constexpr size_t kSnapshotBatch = 1024;
+
+        // 计算条目权重（例如按字节），在锁外调用，每个条目只调用一次
+        using Weigher = std::function<size_t(const Key&, const Value&)>;
+        // 接收被淘汰条目的键和值，在锁外调用（见 set_eviction_listener）
+        using EvictionListener = std::function<void(Key&&, Value&&)>;
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * 只读句柄：持有期间条目不会被淘汰，值不会被修改或移动
+         * 拷贝句柄会增加引用计数，空句柄表示未命中
+         */
+        class Handle {
+        private:
+            friend class LRUCache;
+            template<typename, typename, template<typename> class, typename, typename>
+            friend class ShardedLRUCache;
+
+            LRUCache* owner = nullptr;
+            CacheNode* node = nullptr;
+
+            Handle(LRUCache* o, CacheNode* n) noexcept : owner(o), node(n) {}
+
+        public:
+            Handle() noexcept = default;
+
+            Handle(const Handle& other) noexcept : owner(other.owner), node(other.node) {
+                if (node) {
+                    owner->retain(node);
+                }
+            }
+
+            Handle(Handle&& other) noexcept
+                : owner(std::exchange(other.owner, nullptr)), node(std::exchange(other.node, nullptr)) {}
+
+            Handle& operator=(Handle other) noexcept {
+                std::swap(owner, other.owner);
+                std::swap(node, other.node);
+                return *this;
+            }
+
+            ~Handle() { reset(); }
+
+            void reset() noexcept {
+                if (node) {
+                    owner->release(std::exchange(node, nullptr));
+                    owner = nullptr;
+                }
+            }
+
+            explicit operator bool() const noexcept { return node != nullptr; }
+
+            const Key& key() const noexcept { return node->key; }
+            const Value& operator*() const noexcept { return node->value; }
+            const Value* operator->() const noexcept { return &node->value; }
+        };
+
+    private:
+        // 待销毁节点：在锁内收集，离开作用域时（锁已释放）统一销毁，
+        // 被淘汰的节点先交给淘汰监听器
+        class Graveyard {
+        private:
+            NodeSlabType& slab;
+            const EvictionListener& listener;
+            detail::ListHook* head = nullptr;
+
+        public:
+            explicit Graveyard(LRUCache& cache) noexcept : slab(cache.slab), listener(cache.evictionListener) {}
+            Graveyard(const Graveyard&) = delete;
+            Graveyard& operator=(const Graveyard&) = delete;
+
+            void bury(CacheNode* node) noexcept {
+                node->next = head;
+                head = node;
+            }
+
+            ~Graveyard() {
+                while (head) {
+                    auto* node = static_cast<CacheNode*>(head);
+                    head = head->next;
+                    if (node->notify && listener) {
+                        try {
+                            listener(std::move(node->key), std::move(node->value));
+                        } catch (...) {
+                            // 监听器的异常不能打断其余节点的回收
+                        }
+                    }
+                    slab.destroy(node);
+                }
+            }
+        };
+
+        // 正在加载的键：领头者完成后把结果或异常发布给所有等待者
+        struct Flight {
+            std::mutex mutex;
+            std::condition_variable ready;
+            bool done = false;
+            Handle result;
+            std::exception_ptr error;
+
+            void complete(Handle handle, std::exception_ptr e) {
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    result = std::move(handle);
+                    error = std::move(e);
+                    done = true;
+                }
+                ready.notify_all();
+            }
+
+            Handle wait() {
+                {
+                    std::unique_lock<std::mutex> guard(mutex);
+                    ready.wait(guard, [this] { return done; });
+                }
+                // done 之后 result 和 error 不再改变，拷贝 Handle 时无需持有 mutex
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                return result;
+            }
+        };
+
+        // slab 最先构造、最后析构：所有节点都在它之前归还
+        NodeSlabType slab;
+        SwissIndex<CacheNode> index;
+        Hash hasher;
+        KeyEqual equal;
+        Weigher weigher;
+        EvictionListener evictionListener;
+        size_t maxSize;
+        size_t usage = 0;  // 当前缓存内条目的总权重
+        Policy<CacheNode> policy;  // 只包含未被钉住的条目
+        std::unique_ptr<FrequencySketch> sketch;  // 为空表示不启用准入过滤
+        size_t rejected = 0;
+        std::unique_ptr<NegativeLookupFilter> negative;  // 为空表示不启用否定查找缓存
+        size_t avoidedLoads = 0;
+        std::unique_ptr<TimerWheel<CacheNode>> wheel;  // 第一个带 TTL 的条目插入时创建
+        std::atomic<int64_t> defaultTtl{0};            // 纳秒，0 表示不过期
+        // Flight 只在锁外析构（其中的 Handle 释放时需要加锁）：
+        // 领头者与等待者各持有一份 shared_ptr，这里的引用永远不是最后一个
+        std::unordered_map<Key, std::shared_ptr<Flight>, Hash, KeyEqual> inflight;
+        StatsRecorder recorder;
+        mutable Lock mutex;
+
+        template<typename K>
+        CacheNode* find_node(const K& key) const {
+            return find_hashed(hasher(key), key);
+        }
+
+        template<typename K>
+        CacheNode* find_hashed(size_t hash, const K& key) const {
+            return index.find(hash, [&](const CacheNode* node) {
+                return node->hash == hash && equal(key, node->key);
+            });
+        }
+
+        NodePtr own(CacheNode* node) noexcept { return NodePtr(node, NodeDeleter{&slab}); }
+
+        static bool expired(const CacheNode* node) noexcept {
+            return node->expireAt != 0 && node->expireAt <= detail::steady_now_ns();
+        }
+
+        // 把节点移出索引、策略和时间轮，但不释放缓存持有的引用
+        void unindex(CacheNode* node) noexcept {
+            index.erase(node);
+            if (wheel) {
+                wheel->deschedule(node);
+            }
+            node->inCache = false;
+            usage -= node->charge;
+        }
+
+        void ref(CacheNode* node) noexcept {
+            // 第一个外部引用：退出淘汰候选（钉住）
+            if (node->refs == 1 && node->inCache) {
+                policy.pin(node);
+            }
+            ++node->refs;
+        }
+
+        void unref(CacheNode* node, Graveyard& graveyard) noexcept {
+            assert(node->refs > 0);
+            if (--node->refs == 0) {
+                graveyard.bury(node);
+            } else if (node->refs == 1 && node->inCache) {
+                // 最后一个外部引用释放：重新参与淘汰
+                policy.unpin(node);
+                trim(0, graveyard);
+            }
+        }
+
+        // Handle 使用的加锁版本
+        void retain(CacheNode* node) noexcept {
+            std::lock_guard<Lock> guard(mutex);
+            ref(node);
+        }
+
+        void release(CacheNode* node) noexcept {
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            unref(node, graveyard);
+        }
+
+        // 将节点移出索引并放弃缓存持有的引用
+        void detach(CacheNode* node, Graveyard& graveyard, bool evicted = false) noexcept {
+            policy.remove(node, evicted);
+            unindex(node);
+            unref(node, graveyard);
+        }
+
+        // 按策略淘汰条目，直到再放入 incoming 的权重也不超过容量
+        // 钉住的条目会暂时让缓存超出容量，在它们被释放后收缩
+        // incoming 是正在插入的节点 keep，它已在策略中（接替了旧节点）时由策略跳过
+        void trim(size_t incoming, Graveyard& graveyard, const CacheNode* keep = nullptr) noexcept {
+            while (usage + incoming > maxSize) {
+                CacheNode* victim = policy.victim(keep);
+                if (!victim) {
+                    break;
+                }
+                recorder.add(StatsRecorder::kEvictions);
+                victim->notify = true;
+                detach(victim, graveyard, true);
+            }
+        }
+
+        // TinyLFU：有空间时直接接纳，否则与策略选出的淘汰对象比较频率
+        bool admit(const CacheNode* node) noexcept {
+            if (usage + node->charge <= maxSize) {
+                return true;
+            }
+            const CacheNode* victim = policy.victim();
+            if (!victim || sketch->frequency(node->hash) > sketch->frequency(victim->hash)) {
+                return true;
+            }
+            ++rejected;
+            return false;
+        }
+
+        void touch(CacheNode* node) noexcept {
+            if (node->refs == 1) {
+                policy.access(node);
+            }
+        }
+
+        // 在锁内查找并钉住条目，未命中（或已过期）返回 nullptr
+        template<typename K>
+        CacheNode* acquire(const K& key, Graveyard& graveyard) {
+            CacheNode* node = find_node(key);
+            if (node && expired(node)) {
+                node->notify = true;
+                detach(node, graveyard);
+                node = nullptr;
+            }
+            if (node) {
+                if (sketch) {
+                    sketch->increment(node->hash);
+                }
+                touch(node);
+                ref(node);
+                recorder.add(StatsRecorder::kHits);
+                return node;
+            }
+
+            if (sketch) {
+                sketch->increment(hasher(key));
+            }
+            recorder.add(StatsRecorder::kMisses);
+            return nullptr;
+        }
+
+        template<typename K>
+        Handle lookup(const K& key) {
+            StatsRecorder::Timer timer(recorder, StatsRecorder::kGet);
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            CacheNode* node = acquire(key, graveyard);
+            return node ? Handle(this, node) : Handle();
+        }
+
+        // 在锁外构造节点并计算权重与到期时间
+        template<typename K, typename V>
+        CacheNode* make_node(K&& key, V&& value, Clock::duration ttl) {
+            Key k(std::forward<K>(key));
+            size_t hash = hasher(k);
+            return make_node(hash, std::move(k), std::forward<V>(value), ttl);
+        }
+
+        template<typename V>
+        CacheNode* make_node(size_t hash, Key&& key, V&& value, Clock::duration ttl) {
+            NodePtr node = own(slab.create(hash, std::move(key), std::forward<V>(value)));
+            if (weigher) {
+                node->charge = weigher(node->key, node->value);
+            }
+            if (ttl > Clock::duration::zero()) {
+                node->expireAt = detail::steady_now_ns()
+                    + std::chrono::duration_cast<std::chrono::nanoseconds>(ttl).count();
+            }
+            return node.release();
+        }
+
+        Clock::duration default_ttl() const noexcept {
+            return std::chrono::nanoseconds(defaultTtl.load(std::memory_order_relaxed));
+        }
+
+        template<typename K>
+        bool contains_key(const K& key) const {
+            std::lock_guard<Lock> guard(mutex);
+            const CacheNode* node = find_node(key);
+            return node != nullptr && !expired(node);
+        }
+
+        template<typename K>
+        bool erase_key(const K& key) {
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            CacheNode* node = find_node(key);
+            if (!node) {
+                return false;
+            }
+            detach(node, graveyard);
+            return true;
+        }
+
+        // 在锁内放入新节点（替换同键的旧节点），返回是否放入；
+        // 未放入（超过总容量或被准入过滤拒绝）或抛出异常时节点仍归调用者所有
+        bool insert_node(CacheNode* node, Graveyard& graveyard) {
+            if (negative) {
+                negative->invalidate(node->hash);
+            }
+            CacheNode* old = find_hashed(node->hash, node->key);
+            if (node->charge > maxSize) {
+                // 单个条目超过总容量，不缓存
+                if (old) {
+                    detach(old, graveyard);
+                }
+                return false;
+            }
+            if (sketch) {
+                sketch->increment(node->hash);
+                if (!old && !admit(node)) {
+                    return false;
+                }
+            }
+
+            if (old) {
+                // 新节点接替旧节点在策略中的位置，旧节点随最后一个 Handle 销毁
+                policy.replace(old, node);
+                unindex(old);
+                unref(old, graveyard);
+            }
+            trim(node->charge, graveyard, node);
+            try {
+                index.insert(node);
+                if (node->expireAt != 0 && !wheel) {
+                    wheel = std::make_unique<TimerWheel<CacheNode>>(detail::steady_now_ns());
+                }
+            } catch (...) {
+                index.erase(node);
+                if (old) {
+                    policy.remove(node, false);
+                }
+                throw;
+            }
+            usage += node->charge;
+            if (!old) {
+                policy.insert(node);
+            }
+            if (wheel) {
+                wheel->schedule(node);
+            }
+            recorder.add(old ? StatsRecorder::kUpdates : StatsRecorder::kInserts);
+            return true;
+        }
+
+
+        // 批量查找：一次加锁完成整批，结果写入 out[key.slot]（调用者保证这些位置为空）
+        // 先预取每个键的探测组，第一遍查索引并预取命中的节点，第二遍再做过期检查与访问记录
+        size_t get_hashed(std::span<const detail::HashedKey<Key>> keys, std::span<Handle> out) {
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            for (const auto& key : keys) {
+                index.prefetch(key.hash);
+            }
+            for (const auto& key : keys) {
+                CacheNode* node = find_hashed(key.hash, *key.key);
+                if (node) {
+                    detail::prefetch(node);
+                }
+                out[key.slot].node = node;
+            }
+
+            size_t hits = 0;
+            for (const auto& key : keys) {
+                Handle& handle = out[key.slot];
+                CacheNode* node = handle.node;
+                // 同一个键在一批中出现多次时共用一个节点：过期节点只在第一次出现时摘下，
+                // 之后的出现看到它已不在缓存中（节点在 graveyard 析构前不会释放），按未命中处理
+                if (node && (!node->inCache || expired(node))) {
+                    if (node->inCache) {
+                        node->notify = true;
+                        detach(node, graveyard);
+                    }
+                    node = handle.node = nullptr;
+                }
+                if (sketch) {
+                    sketch->increment(key.hash);
+                }
+                if (node) {
+                    touch(node);
+                    ref(node);
+                    handle.owner = this;
+                    ++hits;
+                }
+            }
+            recorder.add(StatsRecorder::kHits, hits);
+            recorder.add(StatsRecorder::kMisses, keys.size() - hits);
+            return hits;
+        }
+
+        // 批量插入已在锁外构造好的节点，返回放入的条目数；放入缓存的节点
+        // 所有权转交给缓存，未放入的节点留在 nodes 中，由调用者在锁外销毁
+        size_t insert_batch(std::span<NodePtr> nodes) {
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            size_t inserted = 0;
+            for (auto& node : nodes) {
+                if (insert_node(node.get(), graveyard)) {
+                    node.release();
+                    ++inserted;
+                }
+            }
+            return inserted;
+        }
+
+        // 快照条目：剩余 TTL、键、值；写入时已过期的条目跳过
+        void write_entry(SnapshotWriter& out, const CacheNode& node, int64_t nowNs) const {
+            int64_t ttl = 0;
+            if (node.expireAt != 0) {
+                ttl = node.expireAt - nowNs;
+                if (ttl <= 0) {
+                    return;
+                }
+            }
+            out.begin_entry();
+            out.write(ttl);
+            Serializer<Key>::write(out, node.key);
+            Serializer<Value>::write(out, node.value);
+        }
+
+        // 在锁内钉住全部条目，按最近使用顺序（最冷的在前）追加到 handles：先是策略中的
+        // 候选条目，再是已被 Handle 钉住、正在使用的条目
+        void pin_entries(std::vector<Handle>& handles) {
+            std::vector<CacheNode*> nodes;
+            nodes.reserve(index.size());
+            policy.for_each([&](const CacheNode& node) {
+                nodes.push_back(const_cast<CacheNode*>(&node));
+            });
+            index.for_each([&](const CacheNode* node) {
+                if (node->refs > 1) {
+                    nodes.push_back(const_cast<CacheNode*>(node));
+                }
+            });
+            handles.reserve(handles.size() + nodes.size());
+            // 先收集再钉住：钉住会把节点移出策略的链表
+            for (CacheNode* node : nodes) {
+                ref(node);
+                handles.push_back(Handle(this, node));
+            }
+        }
+
+        // 在锁外按 handles 的顺序写出条目
+        void write_entries(SnapshotWriter& out, std::span<const Handle> handles) const {
+            const int64_t nowNs = detail::steady_now_ns();
+            for (const Handle& handle : handles) {
+                write_entry(out, *handle.node, nowNs);
+            }
+        }
+
+        // 在锁外读出下一个快照条目并构造节点
+        CacheNode* read_entry(SnapshotReader& in) {
+            auto ttl = in.read<int64_t>();
+            Key key = Serializer<Key>::read(in);
+            Value value = Serializer<Value>::read(in);
+            return make_node(std::move(key), std::move(value), std::chrono::nanoseconds(ttl));
+        }
+
+        static Handle& as_handle(Handle& handle) noexcept { return handle; }
+        static Handle& as_handle(Handle* handle) noexcept { return *handle; }
+
+        // 释放 handles（Handle 或 Handle* 的序列）中属于本缓存的 Handle，一次加锁
+        template<typename Handles>
+        void release_owned(Handles&& handles) noexcept {
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            for (auto&& item : handles) {
+                Handle& handle = as_handle(item);
+                if (handle.owner == this) {
+                    unref(std::exchange(handle.node, nullptr), graveyard);
+                    handle.owner = nullptr;
+                }
+            }
+        }
+
+        // 从 pair 式元素构造节点：整个 range 是右值容器时移动其中的键和值
+        template<typename R>
+        static constexpr bool owning_range =
+            !std::is_lvalue_reference_v<R> && !std::ranges::view<std::remove_cvref_t<R>>;
+
+        // get_or_compute / get_or_load 的共同实现；factory 返回 std::optional 时
+        // std::nullopt 表示键不存在：不插入，记入否定查找缓存，所有调用者得到空 Handle
+        template<typename F>
+        Handle load(const Key& key, F&& factory) {
+            constexpr bool optional = detail::is_optional<std::remove_cvref_t<std::invoke_result_t<F>>>::value;
+            std::shared_ptr<Flight> flight;
+            bool leader = false;
+            {
+                Graveyard graveyard(*this);
+                std::lock_guard<Lock> guard(mutex);
+                if (CacheNode* node = acquire(key, graveyard)) {
+                    return Handle(this, node);
+                }
+                if (optional && negative && negative->may_contain(hasher(key))) {
+                    ++avoidedLoads;
+                    return Handle();
+                }
+                auto [it, inserted] = inflight.try_emplace(key);
+                if (inserted) {
+                    try {
+                        it->second = std::make_shared<Flight>();
+                    } catch (...) {
+                        inflight.erase(it);
+                        throw;
+                    }
+                }
+                flight = it->second;
+                leader = inserted;
+            }
+            if (!leader) {
+                return flight->wait();
+            }
+
+            Handle result;
+            try {
+                auto value = std::invoke(std::forward<F>(factory));
+                CacheNode* node = nullptr;
+                if constexpr (optional) {
+                    if (!value) {
+                        record_absent(key);
+                        flight->complete(Handle(), nullptr);
+                        return Handle();
+                    }
+                    node = make_node(key, std::move(*value), default_ttl());
+                } else {
+                    node = make_node(key, std::move(value), default_ttl());
+                }
+                Graveyard graveyard(*this);
+                std::lock_guard<Lock> guard(mutex);
+                // 与插入在同一临界区内撤下 Flight，之后到达的调用者直接命中缓存
+                inflight.erase(key);
+                bool cached = false;
+                try {
+                    cached = insert_node(node, graveyard);
+                } catch (...) {
+                    graveyard.bury(node);
+                    throw;
+                }
+                if (cached) {
+                    ref(node);
+                } else {
+                    // 未放入缓存：节点唯一的引用交给 Handle，随最后一个 Handle 销毁
+                    node->inCache = false;
+                }
+                result = Handle(this, node);
+            } catch (...) {
+                {
+                    // 插入（或 record_absent）时抛出的异常发生在 Flight 已撤下之后，期间可能
+                    // 已有新的调用者为同一个键登记了自己的 Flight：只撤下本次加载的 Flight
+                    std::lock_guard<Lock> guard(mutex);
+                    auto it = inflight.find(key);
+                    if (it != inflight.end() && it->second == flight) {
+                        inflight.erase(it);
+                    }
+                }
+                flight->complete(Handle(), std::current_exception());
+                throw;
+            }
+            flight->complete(result, nullptr);
+            return result;
+        }
+
+        // 加载函数确认 key 不存在：撤下 Flight 并记入否定查找缓存
+        // （加载期间 key 已被插入时不记录）
+        void record_absent(const Key& key) {
+            std::lock_guard<Lock> guard(mutex);
+            inflight.erase(key);
+            if (negative && !find_node(key)) {
+                negative->insert(hasher(key));
+            }
+        }
+
+    public:
+        explicit LRUCache(size_t size) : maxSize(size), policy(size) {
+            index.reserve(size);
+        }
+
+        // capacity 与 weigher 使用相同的单位（例如字节）
+        LRUCache(size_t capacity, Weigher w)
+            : weigher(std::move(w)), maxSize(capacity), policy(capacity) {}
+
+        LRUCache(const LRUCache&) = delete;
+        LRUCache& operator=(const LRUCache&) = delete;
+
+        ~LRUCache() {
+            clear();
+        }
+
+        // 完美转发插入（使用默认 TTL）
+        // 节点在锁外构造；已存在的键换入新节点，旧节点随最后一个 Handle 销毁
+        template<typename K, typename V>
+        void put(K&& key, V&& value) {
+            put(std::forward<K>(key), std::forward<V>(value), default_ttl());
+        }
+
+        // 带 TTL 的插入；ttl 为 0 表示永不过期
+        template<typename K, typename V>
+        void put(K&& key, V&& value, Clock::duration ttl) {
+            StatsRecorder::Timer timer(recorder, StatsRecorder::kPut);
+            CacheNode* node = make_node(std::forward<K>(key), std::forward<V>(value), ttl);
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            try {
+                if (!insert_node(node, graveyard)) {
+                    graveyard.bury(node);
+                }
+            } catch (...) {
+                graveyard.bury(node);
+                throw;
+            }
+        }
+
+        // 查找：命中返回钉住条目的 Handle，未命中返回空 Handle，不构造任何 Value
+        // 已过期的条目在这里惰性移除并按未命中处理
+        Handle get(const Key& key) { return lookup(key); }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        Handle get(const K& key) { return lookup(key); }
+
+        /**
+         * 查找，未命中时调用 factory() 生成值并以默认 TTL 插入
+         * 同一个键的并发调用只有一个会执行 factory（在锁外），其余等待并共享
+         * 同一个结果；factory 抛出的异常传给所有等待者，缓存不受影响。
+         * 结果即使被准入过滤拒绝或超过容量，也会通过 Handle 返回给所有调用者
+         */
+        template<typename F>
+        Handle get_or_compute(const Key& key, F&& factory) {
+            return load(key, std::forward<F>(factory));
+        }
+
+        /**
+         * 与 get_or_compute 相同，但 loader() 返回 std::optional<Value>：
+         * std::nullopt 表示数据源中没有这个键，结果为空 Handle，且不插入任何条目。
+         * 启用否定查找缓存后，最近确认不存在的键在调用 loader 之前直接返回空 Handle
+         * （误判率由 enable_negative_cache 设定：少数存在的键也可能被误判为不存在）
+         */
+        template<typename F>
+        Handle get_or_load(const Key& key, F&& loader) {
+            return load(key, std::forward<F>(loader));
+        }
+
+        /**
+         * 批量查找：keys[i] 的结果写入 out[i]（out 至少与 keys 一样长），返回命中数
+         * 哈希在锁外一次算完，整批只加锁一次；out 中原有的 Handle 先被批量释放
+         */
+        size_t multi_get(std::span<const Key> keys, std::span<Handle> out) {
+            assert(out.size() >= keys.size());
+            release_batch(out.first(keys.size()));
+            std::vector<detail::HashedKey<Key>> hashed(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                hashed[i] = {&keys[i], hasher(keys[i]), i};
+            }
+            return get_hashed(hashed, out);
+        }
+
+        // 批量插入 (key, value) 元素（使用默认 TTL）：节点在锁外全部构造好，整批只加锁一次
+        template<std::ranges::input_range R>
+        void multi_put(R&& items) {
+            const Clock::duration ttl = default_ttl();
+            std::vector<NodePtr> nodes;
+            if constexpr (std::ranges::sized_range<R>) {
+                nodes.reserve(std::ranges::size(items));
+            }
+            for (auto&& item : items) {
+                auto&& [key, value] = item;
+                if constexpr (owning_range<R>) {
+                    nodes.push_back(own(make_node(std::move(key), std::move(value), ttl)));
+                } else {
+                    nodes.push_back(own(make_node(key, value, ttl)));
+                }
+            }
+            insert_batch(nodes);
+        }
+
+        /**
+         * 把缓存内容写入快照文件，返回写入的条目数
+         * 条目按最近使用顺序排列（最冷的在前），TTL 以剩余时间保存；
+         * 键和值需要有 Serializer 特化。只在钉住全部条目时持有锁，序列化与磁盘写入
+         * 在锁外进行；写入期间条目不会被淘汰（缓存可能暂时超出容量），写完后一次加锁释放
+         */
+        size_t save_snapshot(const std::string& path) const {
+            // 钉住条目只改变引用计数和淘汰候选，不改变缓存内容
+            auto* self = const_cast<LRUCache*>(this);
+            std::vector<Handle> handles;
+            {
+                std::lock_guard<Lock> guard(mutex);
+                self->pin_entries(handles);
+            }
+            SnapshotWriter out(path);
+            write_entries(out, handles);
+            out.finish();
+            self->release_owned(handles);
+            return out.entry_count();
+        }
+
+        /**
+         * 按文件顺序读回快照并插入（使用快照中记录的剩余 TTL），返回放入的条目数
+         * 节点在锁外构造，每 kSnapshotBatch 个条目加锁插入一次；
+         * 快照大于容量时，最冷的条目会被后读入的条目淘汰
+         */
+        size_t load_snapshot(const std::string& path) {
+            SnapshotReader in(path);
+            std::vector<NodePtr> nodes;
+            nodes.reserve(kSnapshotBatch);
+            size_t loaded = 0;
+            for (uint64_t i = 0; i < in.entry_count(); ++i) {
+                nodes.push_back(own(read_entry(in)));
+                if (nodes.size() == kSnapshotBatch) {
+                    loaded += insert_batch(nodes);
+                    nodes.clear();
+                }
+            }
+            loaded += insert_batch(nodes);
+            return loaded;
+        }
+
+        // 一次加锁释放一批 Handle；属于其他缓存的 Handle 单独释放
+        void release_batch(std::span<Handle> handles) noexcept {
+            release_owned(handles);
+            for (auto& handle : handles) {
+                handle.reset();
+            }
+        }
+
+        bool contains(const Key& key) const { return contains_key(key); }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        bool contains(const K& key) const { return contains_key(key); }
+
+        // 移除条目；被 Handle 引用的节点在最后一个 Handle 释放时销毁
+        bool erase(const Key& key) { return erase_key(key); }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        bool erase(const K& key) { return erase_key(key); }
+
+        void clear() {
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            // SwissIndex 的 erase 只改控制字节，遍历中移除当前节点是安全的
+            index.for_each([&](CacheNode* node) {
+                detach(node, graveyard);
+            });
+            if (negative) {
+                negative->clear();
+            }
+        }
+
+        void print_cache() const {
+            std::lock_guard<Lock> guard(mutex);
+            std::cout << "缓存内容 (按淘汰顺序，不含被钉住的条目): ";
+            policy.for_each([](const CacheNode& node) {
+                std::cout << "[" << node.key << "] ";
+            });
+            std::cout << "\n";
+        }
+
+        // 推进时间轮，主动移除所有已过期的条目，返回移除的条目数
+        // 被 Handle 钉住的过期条目同样移出缓存，随最后一个 Handle 销毁
+        size_t tick(Clock::time_point now = Clock::now()) {
+            const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now.time_since_epoch()).count();
+            Graveyard graveyard(*this);
+            std::lock_guard<Lock> guard(mutex);
+            if (!wheel) {
+                return 0;
+            }
+            return wheel->advance(nowNs, [&](CacheNode* node) {
+                node->notify = true;
+                detach(node, graveyard);
+            });
+        }
+
+        // 之后通过 put(key, value) 插入的条目使用的 TTL；0 表示不过期
+        void set_default_ttl(Clock::duration ttl) noexcept {
+            defaultTtl.store(std::chrono::duration_cast<std::chrono::nanoseconds>(ttl).count(),
+                             std::memory_order_relaxed);
+        }
+
+        // 启用 TinyLFU 准入过滤；expectedEntries 为预期条目数，
+        // 为 0 时取容量（使用 Weigher 按字节计量时应显式传入）
+        void enable_admission_filter(size_t expectedEntries = 0) {
+            auto filter = std::make_unique<FrequencySketch>(expectedEntries ? expectedEntries : maxSize);
+            std::lock_guard<Lock> guard(mutex);
+            sketch = std::move(filter);
+        }
+
+        // 被准入过滤拒绝的插入次数
+        size_t admission_rejections() const {
+            std::lock_guard<Lock> guard(mutex);
+            return rejected;
+        }
+
+        // 启用否定查找缓存：每代记住 expectedAbsentKeys 个不存在的键，
+        // 误判率（存在的键被当作不存在）约为 falsePositiveRate
+        void enable_negative_cache(size_t expectedAbsentKeys, double falsePositiveRate = 0.01) {
+            auto filter = std::make_unique<NegativeLookupFilter>(expectedAbsentKeys, falsePositiveRate);
+            std::lock_guard<Lock> guard(mutex);
+            negative = std::move(filter);
+        }
+
+        // 因否定查找缓存命中而没有调用加载函数的次数
+        size_t loader_calls_avoided() const {
+            std::lock_guard<Lock> guard(mutex);
+            return avoidedLoads;
+        }
+
+        /**
+         * 设置淘汰监听器：被容量淘汰或过期移除的条目，在节点销毁前把键和值
+         * 以右值交给 listener（被 Handle 引用的条目等最后一个 Handle 释放后）；
+         * erase、clear 和同键替换移除的条目不通知。
+         * 监听器在缓存的锁外调用，多线程使用时可能并发调用，抛出的异常被忽略；
+         * 应在缓存开始被并发访问之前设置
+         */
+        void set_eviction_listener(EvictionListener listener) {
+            evictionListener = std::move(listener);
+        }
+
+        // 汇总各条带的计数与延迟直方图；并发更新时只是近似值，不需要加锁
+        CacheStats stats() const noexcept { return recorder.snapshot(); }
+
+        size_t size() const {
+            std::lock_guard<Lock> guard(mutex);
+            return index.size();
+        }
+
+        // 当前总权重（未设置 Weigher 时等于条目数）
+        size_t total_weight() const {
+            std::lock_guard<Lock> guard(mutex);
+            return usage;
+        }
+
+        size_t capacity() const { return maxSize; }
+    };
+
+}
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "cache_system/sharded_lru_cache.hpp"
+#include "cache_system/thread_stripe.hpp"
+
+/**
+ * 线程本地近缓存 - ShardedLRUCache 前面的每线程直接映射小缓存
+ *
+ * 1. 每个线程有自己的一张直接映射表（nearSlots 个槽位），槽位保存键哈希、
+ *    读取时的版本号和共享缓存的 Handle；命中时只读本线程的表、一个版本计数器
+ *    和节点中不可变的键与值，不加锁、不写任何共享缓存行
+ * 2. 版本号按键哈希分到 kVersionStripes 个计数器上，每个计数器独占一条缓存行。
+ *    put / erase 在修改共享缓存之后把键所在条带的版本加一，淘汰监听器对被淘汰
+ *    和过期的键同样加一；clear() 与 tick() 移除了条目时所有条带都加一。
+ *    槽位中记录的版本与当前版本不同即视为失效，回到共享缓存重新读取
+ * 3. 未命中时先读版本再查共享缓存：若查找与某次写入交错，读到的版本一定早于
+ *    写入之后的加一，槽位下一次访问就会失效，不会一直停留在旧值上
+ * 4. 每个线程的命中与未命中分别计数，由 thread_stats() 按线程返回
+ * 5. 线程表放在每个近缓存自己的 kMaxThreads 个位置中：线程第一次访问时领取一个
+ *    空闲位置，并在 thread_local 的登记表中记下；线程退出时登记表析构，释放表中
+ *    所有 Handle 并归还位置，供之后的线程重用。同时存活的线程超过 kMaxThreads 时，
+ *    多出的线程直接读取共享缓存，有位置空出后再领取
+ *
+ * 槽位中的 Handle 会把条目钉在共享缓存中，因此近缓存的总大小应远小于共享缓存
+ * （存活线程数 × nearSlots 个条目不会被淘汰）；槽位被覆盖、线程退出或近缓存析构时释放。
+ * 过期只在 tick() 时反映到近缓存。
+ */
+namespace CacheSystem {
+
+    namespace detail {
+
+        // 区分近缓存实例的编号：线程登记表按编号而不是地址查找，地址可能被新实例重用
+        inline uint64_t next_near_cache_id() noexcept {
+            static std::atomic<uint64_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    }
+
+    // 单个线程的近缓存命中统计
+    struct NearCacheThreadStats {
+        size_t thread;  // 使用该线程表的（最后一个）线程的 thread_stripe() 编号
+        uint64_t hits;
+        uint64_t misses;
+
+        double hit_rate() const noexcept {
+            const uint64_t lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    template<typename Key, typename Value,
+             template<typename> class Policy = LRUPolicy,
+             typename Hash = typename detail::DefaultLookup<Key>::Hash,
+             typename KeyEqual = typename detail::DefaultLookup<Key>::KeyEqual>
+    class NearCache {
+    public:
+        using SharedCache = ShardedLRUCache<Key, Value, Policy, Hash, KeyEqual>;
+        using Handle = typename SharedCache::Handle;
+        using EvictionListener = typename SharedCache::EvictionListener;
+        using Clock = typename SharedCache::Clock;
+
+        static constexpr size_t kVersionStripes = 256;
+        static constexpr size_t kMaxThreads = 256;
+        static constexpr size_t kDefaultNearSlots = 64;
+
+    private:
+        struct alignas(64) Version {
+            std::atomic<uint64_t> value{0};
+        };
+
+        struct Slot {
+            size_t hash = 0;
+            uint64_t version = 0;
+            Handle handle;
+        };
+
+        // 只由所属线程读写；计数器用 relaxed 原子变量，供其他线程汇总
+        struct alignas(64) ThreadTable {
+            std::vector<Slot> slots;
+            std::atomic<uint64_t> hits{0};
+            std::atomic<uint64_t> misses{0};
+            std::atomic<size_t> thread{0};
+            std::atomic<bool> used{false};  // 曾被某个线程领取过（统计保留到位置被重用）
+            bool owned = false;             // 有存活线程正在使用，由 Registry::mutex 保护
+
+            explicit ThreadTable(size_t n) : slots(n) {}
+
+            void count(std::atomic<uint64_t>& counter) noexcept {
+                counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        };
+
+        // 线程表位置的分配状态；由近缓存与各线程的登记表共同持有，
+        // 线程退出时据此判断近缓存是否还存在
+        struct Registry {
+            std::mutex mutex;
+            bool alive = true;
+            std::atomic<size_t> owned{0};
+        };
+
+        struct Registration {
+            uint64_t cacheId;
+            ThreadTable* table;
+            std::weak_ptr<Registry> registry;
+        };
+
+        // 每个线程一份：线程退出时释放它在各个（仍然存在的）近缓存中的线程表
+        struct ThreadRegistrations {
+            std::vector<Registration> entries;
+
+            ~ThreadRegistrations() {
+                for (auto& entry : entries) {
+                    if (auto registry = entry.registry.lock()) {
+                        std::lock_guard lock(registry->mutex);
+                        if (registry->alive) {
+                            release(*entry.table);
+                            registry->owned.fetch_sub(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            }
+        };
+
+        static void release(ThreadTable& table) noexcept {
+            for (auto& slot : table.slots) {
+                slot.handle.reset();
+            }
+            table.owned = false;
+        }
+
+        Hash hasher;
+        KeyEqual equal;
+        size_t slotMask;
+        Version versions[kVersionStripes];
+        const uint64_t cacheId = detail::next_near_cache_id();
+        std::shared_ptr<Registry> registry = std::make_shared<Registry>();
+        std::unique_ptr<std::atomic<ThreadTable*>[]> tables;
+        EvictionListener userListener;
+        // 声明在最后、最先析构：监听器用到的成员此时仍然有效；
+        // 线程表（以及槽位中的 Handle）在析构函数体中已经释放
+        SharedCache shared;
+
+        std::atomic<uint64_t>& version_for(size_t hash) noexcept {
+            return versions[detail::mix_hash(hash) & (kVersionStripes - 1)].value;
+        }
+
+        void bump(size_t hash) noexcept {
+            version_for(hash).fetch_add(1, std::memory_order_release);
+        }
+
+        void bump_all() noexcept {
+            for (auto& v : versions) {
+                v.value.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        // 没有空闲位置时返回 nullptr，之后的访问会再次尝试
+        ThreadTable* claim_table(ThreadRegistrations& registrations) {
+            if (registry->owned.load(std::memory_order_relaxed) >= kMaxThreads) {
+                return nullptr;
+            }
+            // 先准备好登记项的空间，领取位置之后不再有可能抛出异常的操作；
+            // 顺便丢掉已析构的近缓存留下的登记
+            std::erase_if(registrations.entries, [](const Registration& e) { return e.registry.expired(); });
+            registrations.entries.reserve(registrations.entries.size() + 1);
+            std::lock_guard lock(registry->mutex);
+            for (size_t i = 0; i < kMaxThreads; ++i) {
+                ThreadTable* table = tables[i].load(std::memory_order_relaxed);
+                if (table && table->owned) {
+                    continue;
+                }
+                if (!table) {
+                    table = new ThreadTable(slotMask + 1);
+                    tables[i].store(table, std::memory_order_release);
+                }
+                table->owned = true;
+                table->hits.store(0, std::memory_order_relaxed);
+                table->misses.store(0, std::memory_order_relaxed);
+                table->thread.store(detail::thread_stripe(), std::memory_order_relaxed);
+                table->used.store(true, std::memory_order_release);
+                registry->owned.fetch_add(1, std::memory_order_relaxed);
+                registrations.entries.push_back({cacheId, table, registry});
+                return table;
+            }
+            return nullptr;
+        }
+
+        // 本线程的表，首次访问时领取；没有空闲位置时返回 nullptr
+        ThreadTable* local_table() {
+            static thread_local ThreadRegistrations registrations;
+            for (const auto& entry : registrations.entries) {
+                if (entry.cacheId == cacheId) {
+                    return entry.table;
+                }
+            }
+            return claim_table(registrations);
+        }
+
+    public:
+        // capacity 与 shardCount 传给共享缓存；nearSlots 为每个线程的槽位数（向上取 2 的幂）
+        explicit NearCache(size_t capacity,
+                           size_t shardCount = SharedCache::kDefaultShardCount,
+                           size_t nearSlots = kDefaultNearSlots)
+            : slotMask(detail::round_up_pow2(nearSlots) - 1),
+              tables(new std::atomic<ThreadTable*>[kMaxThreads]),
+              shared(capacity, shardCount) {
+            for (size_t i = 0; i < kMaxThreads; ++i) {
+                tables[i].store(nullptr, std::memory_order_relaxed);
+            }
+            shared.set_eviction_listener([this](Key&& key, Value&& value) {
+                bump(hasher(key));
+                if (userListener) {
+                    userListener(std::move(key), std::move(value));
+                }
+            });
+        }
+
+        NearCache(const NearCache&) = delete;
+        NearCache& operator=(const NearCache&) = delete;
+
+        ~NearCache() {
+            // 之后退出的线程不再访问线程表
+            {
+                std::lock_guard lock(registry->mutex);
+                registry->alive = false;
+            }
+            for (size_t i = 0; i < kMaxThreads; ++i) {
+                delete tables[i].load(std::memory_order_acquire);
+            }
+        }
+
+        template<typename K, typename V>
+        void put(K&& key, V&& value) {
+            Key k(std::forward<K>(key));
+            const size_t hash = hasher(k);
+            shared.put(std::move(k), std::forward<V>(value));
+            bump(hash);
+        }
+
+        /**
+         * 以值的常量引用调用 f，未命中时返回 false
+         * 命中近缓存时不加锁；引用只在 f 内有效
+         */
+        template<typename F>
+        bool read(const Key& key, F&& f) {
+            const size_t hash = hasher(key);
+            auto& version = version_for(hash);
+            ThreadTable* table = local_table();
+            if (!table) {
+                Handle handle = shared.get(key);
+                if (handle) {
+                    f(*handle);
+                }
+                return static_cast<bool>(handle);
+            }
+
+            Slot& slot = table->slots[detail::mix_hash(hash) & slotMask];
+            if (slot.handle && slot.hash == hash && equal(slot.handle.key(), key) &&
+                slot.version == version.load(std::memory_order_acquire)) {
+                table->count(table->hits);
+                f(*slot.handle);
+                return true;
+            }
+
+            table->count(table->misses);
+            const uint64_t seen = version.load(std::memory_order_acquire);
+            Handle handle = shared.get(key);
+            if (!handle) {
+                return false;
+            }
+            slot.hash = hash;
+            slot.version = seen;
+            slot.handle = std::move(handle);
+            f(*slot.handle);
+            return true;
+        }
+
+        bool contains(const Key& key) const { return shared.contains(key); }
+
+        bool erase(const Key& key) {
+            const bool erased = shared.erase(key);
+            bump(hasher(key));
+            return erased;
+        }
+
+        void clear() {
+            shared.clear();
+            bump_all();
+        }
+
+        size_t tick(typename Clock::time_point now = Clock::now()) {
+            const size_t expired = shared.tick(now);
+            if (expired > 0) {
+                bump_all();
+            }
+            return expired;
+        }
+
+        // 监听器在版本号更新之后调用；应在开始并发访问之前设置
+        void set_eviction_listener(EvictionListener listener) {
+            userListener = std::move(listener);
+        }
+
+        // 每个线程表一项：正在使用的线程，以及位置还未被重用的已退出线程
+        std::vector<NearCacheThreadStats> thread_stats() const {
+            std::vector<NearCacheThreadStats> result;
+            for (size_t i = 0; i < kMaxThreads; ++i) {
+                const ThreadTable* table = tables[i].load(std::memory_order_acquire);
+                if (table && table->used.load(std::memory_order_acquire)) {
+                    result.push_back({table->thread.load(std::memory_order_relaxed),
+                                      table->hits.load(std::memory_order_relaxed),
+                                      table->misses.load(std::memory_order_relaxed)});
+                }
+            }
+            return result;
+        }
+
+        // 只读访问：经共享缓存直接写入不会更新版本号，各线程的近缓存会一直读到旧值，
+        // 所有修改都必须经过 NearCache
+        const SharedCache& shared_cache() const noexcept { return shared; }
+        CacheStats stats() const { return shared.stats(); }
+        size_t size() const { return shared.size(); }
+        size_t capacity() const { return shared.capacity(); }
+    };
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * 否定查找过滤器 - 记录最近确认不存在的键，让加载函数不必为它们重复运行
+ *
+ * 分块布隆过滤器：每个键的 k 个位都落在同一个 64 字节块（8 个 uint64_t）内，
+ * 一次查询只访问一条缓存行。位数按目标误判率 p 计算（每个键约 -ln p / ln²2 位，
+ * 分块带来的误判率上升由额外 20% 的位补偿）。
+ *
+ * 布隆过滤器不能删除，因此：
+ * 1. 分两代：当前代插入满 expectedKeys 个键后成为上一代，原来的上一代被清空
+ *    重用为新的当前代；查询同时检查两代，每代按 p / 2 设计，合计误判率不超过 p，
+ *    记住的是最近 expectedKeys ~ 2 × expectedKeys 个不存在的键
+ * 2. 失效：键被插入缓存时，若过滤器认为它不存在，就把哈希放入失效集合，
+ *    失效集合中的哈希查询结果总是"可能存在"；轮换时清理已不在任一代中的哈希。
+ *    失效集合超过 expectedKeys / 4 时直接清空整个过滤器（只会让加载函数多运行几次）
+ * 非线程安全，由 LRUCache 在锁内调用。
+ */
+namespace CacheSystem {
+
+    class NegativeLookupFilter {
+    private:
+        static constexpr size_t kBlockWords = 8;
+        static constexpr size_t kBlockBits = kBlockWords * 64;
+
+        struct Generation {
+            std::vector<uint64_t> words;
+            size_t count = 0;
+
+            bool test(size_t block, uint64_t bits, unsigned k) const noexcept {
+                const uint64_t* b = &words[block * kBlockWords];
+                for (unsigned i = 0; i < k; ++i, bits >>= 9) {
+                    const unsigned bit = static_cast<unsigned>(bits & (kBlockBits - 1));
+                    if (!(b[bit >> 6] & (uint64_t{1} << (bit & 63)))) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void set(size_t block, uint64_t bits, unsigned k) noexcept {
+                uint64_t* b = &words[block * kBlockWords];
+                for (unsigned i = 0; i < k; ++i, bits >>= 9) {
+                    const unsigned bit = static_cast<unsigned>(bits & (kBlockBits - 1));
+                    b[bit >> 6] |= uint64_t{1} << (bit & 63);
+                }
+            }
+        };
+
+        Generation current;
+        Generation previous;
+        std::unordered_set<uint64_t> invalidated;
+        size_t blockMask = 0;
+        size_t perGeneration;
+        unsigned hashes;  // 每个键设置的位数 k（不超过 7，9 位一组取自同一个 64 位哈希）
+
+        static uint64_t rehash(uint64_t hash) noexcept {
+            uint64_t h = hash * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 29;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            return h ^ (h >> 32);
+        }
+
+        // 块编号取自原哈希的混合，块内位置取自再次混合的 64 位
+        size_t block_of(uint64_t hash) const noexcept {
+            return static_cast<size_t>((hash * 0xff51afd7ed558ccdULL) >> 32) & blockMask;
+        }
+
+        bool in_generations(uint64_t hash) const noexcept {
+            const size_t block = block_of(hash);
+            const uint64_t bits = rehash(hash);
+            return current.test(block, bits, hashes) || previous.test(block, bits, hashes);
+        }
+
+        void rotate() {
+            std::swap(current, previous);
+            std::fill(current.words.begin(), current.words.end(), 0);
+            current.count = 0;
+            std::erase_if(invalidated, [this](uint64_t hash) { return !in_generations(hash); });
+        }
+
+    public:
+        // expectedKeys：每代容纳的键数；falsePositiveRate：两代合计的目标误判率
+        explicit NegativeLookupFilter(size_t expectedKeys, double falsePositiveRate = 0.01)
+            : perGeneration(std::max<size_t>(expectedKeys, 1)) {
+            const double p = std::clamp(falsePositiveRate, 1e-6, 0.5) / 2;
+            const double bitsPerKey = -std::log(p) / (std::log(2.0) * std::log(2.0)) * 1.2;
+            hashes = static_cast<unsigned>(std::clamp(std::lround(bitsPerKey * std::log(2.0) / 1.2), 1L, 7L));
+            const auto bits = static_cast<size_t>(bitsPerKey * static_cast<double>(perGeneration));
+            size_t blocks = 1;
+            while (blocks * kBlockBits < bits) {
+                blocks <<= 1;
+            }
+            blockMask = blocks - 1;
+            current.words.assign(blocks * kBlockWords, 0);
+            previous.words.assign(blocks * kBlockWords, 0);
+        }
+
+        // 可能是最近确认不存在的键（误判率约为 p）；返回 false 时一定不在过滤器中
+        bool may_contain(uint64_t hash) const noexcept {
+            return in_generations(hash) && !invalidated.contains(hash);
+        }
+
+        // 记录一个确认不存在的键
+        void insert(uint64_t hash) {
+            invalidated.erase(hash);
+            current.set(block_of(hash), rehash(hash), hashes);
+            if (++current.count >= perGeneration) {
+                rotate();
+            }
+        }
+
+        // 键已存在（被插入缓存）：之后的查询不再认为它不存在
+        void invalidate(uint64_t hash) {
+            if (!may_contain(hash)) {
+                return;
+            }
+            if (invalidated.size() >= perGeneration / 4) {
+                clear();
+                return;
+            }
+            invalidated.insert(hash);
+        }
+
+        void clear() noexcept {
+            std::fill(current.words.begin(), current.words.end(), 0);
+            std::fill(previous.words.begin(), previous.words.end(), 0);
+            current.count = 0;
+            previous.count = 0;
+            invalidated.clear();
+        }
+
+        unsigned hash_count() const noexcept { return hashes; }
+
+        // 两代位数组占用的字节数（不含失效集合）
+        size_t memory_usage() const noexcept {
+            return (current.words.size() + previous.words.size()) * sizeof(uint64_t);
+        }
+    };
+
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * 整数序列编码 - 冷条目的增量 + varint / 游程压缩
+ *
+ * 先对序列做差分（相邻元素之差按 zigzag 映射为无符号数），再选两种编码中较小的一种：
+ *   kDeltaVarint  每个差值写成 LEB128 varint，适合有序、间隔较小的序列
+ *   kDeltaRuns    差值的游程：(差值, 重复次数) 成对写成 varint，适合等差序列
+ *                 （std::iota 生成的整段只有一个游程）和大量重复值（差值为 0 的游程）
+ * 两种编码都不比原始数据小时保存原始字节（kRaw），保证编码结果不会变大。
+ *
+ * 解码是热路径：varint 解码一次读 8 个字节，8 个字节都没有延续位时
+ * （差值都小于 64）整组直接展开，只有遇到多字节 varint 时才逐字节处理；
+ * 游程解码是没有分支的等差展开。编码只在条目变冷时做一次，不追求极致速度。
+ */
+namespace CacheSystem {
+
+    enum class SequenceEncoding : uint8_t { kRaw, kDeltaVarint, kDeltaRuns };
+
+    namespace detail {
+
+        inline size_t varint_size(uint64_t v) noexcept {
+            return (static_cast<size_t>(std::bit_width(v | 1)) + 6) / 7;
+        }
+
+        inline unsigned char* write_varint(unsigned char* out, uint64_t v) noexcept {
+            while (v >= 0x80) {
+                *out++ = static_cast<unsigned char>(v | 0x80);
+                v >>= 7;
+            }
+            *out++ = static_cast<unsigned char>(v);
+            return out;
+        }
+
+        inline const unsigned char* read_varint(const unsigned char* in, const unsigned char* end, uint64_t& v) {
+            v = 0;
+            for (unsigned shift = 0; in < end && shift < 64; shift += 7) {
+                const unsigned char byte = *in++;
+                v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (byte < 0x80) {
+                    return in;
+                }
+            }
+            throw std::runtime_error("序列编码数据损坏");
+        }
+
+        // 差值在 T 的位宽内按 zigzag 映射：小的正负差值都得到小的无符号数
+        template<std::integral T>
+        struct ZigZag {
+            using U = std::make_unsigned_t<T>;
+            static constexpr unsigned kBits = sizeof(T) * 8;
+
+            static uint64_t delta(U prev, U cur) noexcept {
+                const U d = static_cast<U>(cur - prev);
+                const U sign = (d >> (kBits - 1)) ? static_cast<U>(~U{0}) : U{0};
+                return static_cast<U>(static_cast<U>(d << 1) ^ sign);
+            }
+
+            static U apply(U prev, uint64_t zz) noexcept {
+                const U z = static_cast<U>(zz);
+                const U d = static_cast<U>((z >> 1) ^ static_cast<U>(U{0} - (z & 1)));
+                return static_cast<U>(prev + d);
+            }
+        };
+
+    }
+
+    /**
+     * 编码后的整数序列：只占编码结果大小的堆内存（外加对象本身）
+     * 不可变，只能移动
+     */
+    template<std::integral T>
+    class PackedSequence {
+    private:
+        using U = std::make_unsigned_t<T>;
+        using Z = detail::ZigZag<T>;
+
+        std::unique_ptr<unsigned char[]> data;
+        size_t byteCount = 0;
+        size_t count = 0;
+        SequenceEncoding kind = SequenceEncoding::kRaw;
+
+        void decode_varint(T* out) const {
+            const unsigned char* in = data.get();
+            const unsigned char* end = in + byteCount;
+            U prev = 0;
+            size_t i = 0;
+            while (i < count) {
+                // 快速路径：接下来 8 个字节都是单字节 varint
+                if (count - i >= 8 && end - in >= 8) {
+                    uint64_t word;
+                    std::memcpy(&word, in, sizeof(word));
+                    if ((word & 0x8080808080808080ULL) == 0) {
+                        for (size_t k = 0; k < 8; ++k) {
+                            prev = Z::apply(prev, (word >> (k * 8)) & 0xff);
+                            out[i + k] = static_cast<T>(prev);
+                        }
+                        in += 8;
+                        i += 8;
+                        continue;
+                    }
+                }
+                uint64_t zz;
+                in = detail::read_varint(in, end, zz);
+                prev = Z::apply(prev, zz);
+                out[i++] = static_cast<T>(prev);
+            }
+        }
+
+        void decode_runs(T* out) const {
+            const unsigned char* in = data.get();
+            const unsigned char* end = in + byteCount;
+            U prev = 0;
+            size_t i = 0;
+            while (i < count) {
+                uint64_t zz;
+                uint64_t run;
+                in = detail::read_varint(in, end, zz);
+                in = detail::read_varint(in, end, run);
+                if (run == 0 || run > count - i) {
+                    throw std::runtime_error("序列编码数据损坏");
+                }
+                const U d = static_cast<U>(Z::apply(0, zz));
+                for (const size_t stop = i + run; i < stop; ++i) {
+                    prev = static_cast<U>(prev + d);
+                    out[i] = static_cast<T>(prev);
+                }
+            }
+        }
+
+    public:
+        PackedSequence() = default;
+
+        static PackedSequence encode(std::span<const T> values) {
+            // 第一遍没有分支：varint 编码的大小与差值变化的次数（游程数的估计）
+            size_t varintBytes = 0;
+            size_t runs = 0;
+            U prev = 0;
+            uint64_t last = ~uint64_t{0};
+            for (T value : values) {
+                const uint64_t zz = Z::delta(prev, static_cast<U>(value));
+                prev = static_cast<U>(value);
+                varintBytes += detail::varint_size(zz);
+                runs += zz != last;
+                last = zz;
+            }
+
+            // 每个游程至少 2 个字节：游程太多时游程编码不可能更小，不再精确计算
+            size_t runBytes = SIZE_MAX;
+            uint64_t runDelta = 0;
+            size_t run = 0;
+            if (runs * 2 < varintBytes) {
+                runBytes = 0;
+                prev = 0;
+                for (T value : values) {
+                    const uint64_t zz = Z::delta(prev, static_cast<U>(value));
+                    prev = static_cast<U>(value);
+                    if (run > 0 && zz == runDelta) {
+                        ++run;
+                        continue;
+                    }
+                    if (run > 0) {
+                        runBytes += detail::varint_size(runDelta) + detail::varint_size(run);
+                    }
+                    runDelta = zz;
+                    run = 1;
+                }
+                if (run > 0) {
+                    runBytes += detail::varint_size(runDelta) + detail::varint_size(run);
+                }
+            }
+
+            PackedSequence result;
+            result.count = values.size();
+            const size_t rawBytes = values.size_bytes();
+            result.kind = SequenceEncoding::kRaw;
+            result.byteCount = rawBytes;
+            if (varintBytes < result.byteCount) {
+                result.kind = SequenceEncoding::kDeltaVarint;
+                result.byteCount = varintBytes;
+            }
+            if (runBytes < result.byteCount) {
+                result.kind = SequenceEncoding::kDeltaRuns;
+                result.byteCount = runBytes;
+            }
+            if (result.byteCount == 0) {
+                return result;
+            }
+
+            auto buffer = std::make_unique_for_overwrite<unsigned char[]>(result.byteCount);
+            unsigned char* out = buffer.get();
+            switch (result.kind) {
+            case SequenceEncoding::kRaw:
+                std::memcpy(out, values.data(), rawBytes);
+                break;
+            case SequenceEncoding::kDeltaVarint:
+                prev = 0;
+                for (T value : values) {
+                    out = detail::write_varint(out, Z::delta(prev, static_cast<U>(value)));
+                    prev = static_cast<U>(value);
+                }
+                break;
+            case SequenceEncoding::kDeltaRuns:
+                prev = 0;
+                run = 0;
+                for (T value : values) {
+                    const uint64_t zz = Z::delta(prev, static_cast<U>(value));
+                    prev = static_cast<U>(value);
+                    if (run > 0 && zz == runDelta) {
+                        ++run;
+                        continue;
+                    }
+                    if (run > 0) {
+                        out = detail::write_varint(detail::write_varint(out, runDelta), run);
+                    }
+                    runDelta = zz;
+                    run = 1;
+                }
+                out = detail::write_varint(detail::write_varint(out, runDelta), run);
+                break;
+            }
+            result.data = std::move(buffer);
+            return result;
+        }
+
+        // 解码到 out（覆盖原有内容，复用其容量）
+        void decode_into(std::vector<T>& out) const {
+            out.resize(count);
+            switch (kind) {
+            case SequenceEncoding::kRaw:
+                if (count > 0) {
+                    std::memcpy(out.data(), data.get(), count * sizeof(T));
+                }
+                break;
+            case SequenceEncoding::kDeltaVarint:
+                decode_varint(out.data());
+                break;
+            case SequenceEncoding::kDeltaRuns:
+                decode_runs(out.data());
+                break;
+            }
+        }
+
+        std::vector<T> decode() const {
+            std::vector<T> out;
+            decode_into(out);
+            return out;
+        }
+
+        size_t size() const noexcept { return count; }
+        size_t encoded_bytes() const noexcept { return byteCount; }
+        size_t raw_bytes() const noexcept { return count * sizeof(T); }
+        SequenceEncoding encoding() const noexcept { return kind; }
+    };
+
+}
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cache_system/lru_cache.hpp"
+
+/**
+ * 分片并发 LRU 缓存
+ *
+ * 键按哈希值分布到 N 个独立加锁的分片上，每个分片是一个带 std::mutex 的
+ * LRUCache，拥有自己的最近使用顺序和 1/N 的容量。不同分片上的操作互不阻塞，
+ * 分片数为 1 时退化为单一全局锁。
+ *
+ * 淘汰在分片内进行：某个分片满时只按该分片自己的策略淘汰条目。
+ *
+ * 批量操作先在锁外算好所有键的哈希并按分片分组，每个涉及到的分片只加锁一次；
+ * 分片内查找直接复用这里算好的哈希。
+ */
+namespace CacheSystem {
+
+    namespace detail {
+
+        // 打散哈希值的高位用于选择分片，避免与分片内部索引使用相同的低位
+        inline size_t mix_hash(size_t hash) noexcept {
+            uint64_t h = static_cast<uint64_t>(hash);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            return static_cast<size_t>(h);
+        }
+
+        inline size_t round_up_pow2(size_t n) noexcept {
+            size_t p = 1;
+            while (p < n) {
+                p <<= 1;
+            }
+            return p;
+        }
+
+    }
+
+    template<typename Key, typename Value,
+             template<typename> class Policy = LRUPolicy,
+             typename Hash = typename detail::DefaultLookup<Key>::Hash,
+             typename KeyEqual = typename detail::DefaultLookup<Key>::KeyEqual>
+    class ShardedLRUCache {
+    public:
+        using Shard = LRUCache<Key, Value, Policy, Hash, KeyEqual, std::mutex>;
+        using Handle = typename Shard::Handle;
+        using Weigher = typename Shard::Weigher;
+        using EvictionListener = typename Shard::EvictionListener;
+        using Clock = typename Shard::Clock;
+
+        static constexpr size_t kDefaultShardCount = 16;
+
+    private:
+        std::vector<std::unique_ptr<Shard>> shards;
+        Hash hasher;
+        size_t shardMask;
+        size_t maxSize;
+
+        template<typename K>
+        Shard& shard_for(const K& key) const {
+            return *shards[shard_index(hasher(key))];
+        }
+
+        size_t shard_index(size_t hash) const noexcept {
+            return detail::mix_hash(hash) & shardMask;
+        }
+
+        // 把各分片上构造好的节点按分片分组后插入，每个分片加锁一次，返回放入的条目数
+        size_t insert_grouped(std::vector<typename Shard::NodePtr>& nodes,
+                              const std::vector<size_t>& shardOf) {
+            auto offsets = group_by_shard(nodes, shardOf);
+            std::span<typename Shard::NodePtr> all(nodes);
+            size_t inserted = 0;
+            for (size_t s = 0; s < shards.size(); ++s) {
+                if (offsets[s] != offsets[s + 1]) {
+                    inserted += shards[s]->insert_batch(all.subspan(offsets[s], offsets[s + 1] - offsets[s]));
+                }
+            }
+            return inserted;
+        }
+
+        // 在键所属的分片上构造节点（锁外，使用该分片的 slab），并记录分片下标
+        template<typename V>
+        typename Shard::NodePtr make_node(Key&& key, V&& value, typename Clock::duration ttl,
+                                          std::vector<size_t>& shardOf) {
+            size_t hash = hasher(key);
+            size_t s = shard_index(hash);
+            shardOf.push_back(s);
+            Shard& shard = *shards[s];
+            return shard.own(shard.make_node(hash, std::move(key), std::forward<V>(value), ttl));
+        }
+
+        // 计数排序：按分片把 items 稳定地分组，返回每个分片在结果中的起始位置
+        // （offsets[s] 到 offsets[s + 1] 为第 s 个分片）
+        template<typename T>
+        std::vector<size_t> group_by_shard(std::vector<T>& items, const std::vector<size_t>& shardOf) const {
+            std::vector<size_t> offsets(shards.size() + 1, 0);
+            for (size_t s : shardOf) {
+                ++offsets[s];
+            }
+            for (size_t i = 1; i < shards.size(); ++i) {
+                offsets[i] += offsets[i - 1];
+            }
+            offsets[shards.size()] = items.size();
+            // 此时 offsets[s] 是分片 s 的结束位置；从后往前放置并递减，结束后正好是起始位置
+            std::vector<T> grouped(items.size());
+            for (size_t i = items.size(); i-- > 0;) {
+                grouped[--offsets[shardOf[i]]] = std::move(items[i]);
+            }
+            items = std::move(grouped);
+            return offsets;
+        }
+
+    public:
+        // shardCount 会向上取整到 2 的幂，容量平均分配到各分片（向上取整）
+        // 设置 weigher 时 capacity 为总权重（例如字节），同样按分片均分
+        explicit ShardedLRUCache(size_t capacity, size_t shardCount = kDefaultShardCount,
+                                 Weigher weigher = {})
+            : shardMask(detail::round_up_pow2(shardCount == 0 ? 1 : shardCount) - 1),
+              maxSize(capacity) {
+            const size_t count = shardMask + 1;
+            const size_t perShard = (capacity + count - 1) / count;
+            shards.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                shards.push_back(weigher ? std::make_unique<Shard>(perShard, weigher)
+                                         : std::make_unique<Shard>(perShard));
+            }
+        }
+
+        template<typename K, typename V>
+        void put(K&& key, V&& value) {
+            Key k(std::forward<K>(key));
+            Shard& shard = shard_for(k);
+            shard.put(std::move(k), std::forward<V>(value));
+        }
+
+        template<typename K, typename V>
+        void put(K&& key, V&& value, typename Clock::duration ttl) {
+            Key k(std::forward<K>(key));
+            Shard& shard = shard_for(k);
+            shard.put(std::move(k), std::forward<V>(value), ttl);
+        }
+
+        Handle get(const Key& key) {
+            return shard_for(key).get(key);
+        }
+
+        /**
+         * 批量查找：keys[i] 的结果写入 out[i]（out 至少与 keys 一样长），返回命中数
+         * 哈希在锁外一次算完，键按分片分组，每个涉及到的分片只加锁一次
+         */
+        size_t multi_get(std::span<const Key> keys, std::span<Handle> out) {
+            assert(out.size() >= keys.size());
+            release_batch(out.first(keys.size()));
+
+            std::vector<detail::HashedKey<Key>> hashed(keys.size());
+            std::vector<size_t> shardOf(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                size_t hash = hasher(keys[i]);
+                hashed[i] = {&keys[i], hash, i};
+                shardOf[i] = shard_index(hash);
+            }
+            auto offsets = group_by_shard(hashed, shardOf);
+
+            size_t hits = 0;
+            std::span<const detail::HashedKey<Key>> all(hashed);
+            for (size_t s = 0; s < shards.size(); ++s) {
+                if (offsets[s] != offsets[s + 1]) {
+                    hits += shards[s]->get_hashed(all.subspan(offsets[s], offsets[s + 1] - offsets[s]), out);
+                }
+            }
+            return hits;
+        }
+
+        // 批量插入 (key, value) 元素：节点在锁外构造并按分片分组，每个分片只加锁一次
+        template<std::ranges::input_range R>
+        void multi_put(R&& items) {
+            const typename Clock::duration ttl = shards.front()->default_ttl();
+            std::vector<typename Shard::NodePtr> nodes;
+            std::vector<size_t> shardOf;
+            if constexpr (std::ranges::sized_range<R>) {
+                nodes.reserve(std::ranges::size(items));
+                shardOf.reserve(std::ranges::size(items));
+            }
+            for (auto&& item : items) {
+                auto&& [key, value] = item;
+                if constexpr (Shard::template owning_range<R>) {
+                    nodes.push_back(make_node(Key(std::move(key)), std::move(value), ttl, shardOf));
+                } else {
+                    nodes.push_back(make_node(Key(key), value, ttl, shardOf));
+                }
+            }
+            insert_grouped(nodes, shardOf);
+        }
+
+        // 批量释放 Handle：按分片分组，每个涉及到的分片只加锁一次
+        void release_batch(std::span<Handle> handles) noexcept {
+            if (std::none_of(handles.begin(), handles.end(), [](const Handle& h) { return h.node; })) {
+                return;
+            }
+            std::vector<Handle*> owned;
+            std::vector<size_t> shardOf;
+            try {
+                for (auto& handle : handles) {
+                    if (handle.node && handle.owner == shards[shard_index(handle.node->hash)].get()) {
+                        owned.push_back(&handle);
+                        shardOf.push_back(shard_index(handle.node->hash));
+                    }
+                }
+                auto offsets = group_by_shard(owned, shardOf);
+                std::span<Handle* const> all(owned);
+                for (size_t s = 0; s < shards.size(); ++s) {
+                    if (offsets[s] != offsets[s + 1]) {
+                        shards[s]->release_owned(all.subspan(offsets[s], offsets[s + 1] - offsets[s]));
+                    }
+                }
+            } catch (...) {
+                // 分组时内存不足：退回逐个释放
+            }
+            for (auto& handle : handles) {
+                handle.reset();
+            }
+        }
+
+        /**
+         * 依次写出各分片的条目（格式与 LRUCache 相同），返回写入的条目数
+         * 每个分片内按最近使用顺序排列；只在钉住某个分片的条目时持有该分片的锁，
+         * 同一时间只有一个分片的条目被钉住
+         */
+        size_t save_snapshot(const std::string& path) const {
+            SnapshotWriter out(path);
+            std::vector<Handle> handles;
+            for (const auto& shard : shards) {
+                handles.clear();
+                {
+                    std::lock_guard<std::mutex> guard(shard->mutex);
+                    shard->pin_entries(handles);
+                }
+                shard->write_entries(out, handles);
+                shard->release_owned(handles);
+            }
+            out.finish();
+            return out.entry_count();
+        }
+
+        // 读回快照：条目按键重新分片，分片内保持文件中的顺序，分批插入
+        size_t load_snapshot(const std::string& path) {
+            SnapshotReader in(path);
+            std::vector<typename Shard::NodePtr> nodes;
+            std::vector<size_t> shardOf;
+            size_t loaded = 0;
+            for (uint64_t i = 0; i < in.entry_count(); ++i) {
+                auto ttl = in.read<int64_t>();
+                Key key = Serializer<Key>::read(in);
+                Value value = Serializer<Value>::read(in);
+                nodes.push_back(make_node(std::move(key), std::move(value),
+                                          std::chrono::nanoseconds(ttl), shardOf));
+                if (nodes.size() == Shard::kSnapshotBatch) {
+                    loaded += insert_grouped(nodes, shardOf);
+                    nodes.clear();
+                    shardOf.clear();
+                }
+            }
+            loaded += insert_grouped(nodes, shardOf);
+            return loaded;
+        }
+
+        // 加载在键所属的分片内合并，不同分片的加载互不影响
+        template<typename F>
+        Handle get_or_compute(const Key& key, F&& factory) {
+            return shard_for(key).get_or_compute(key, std::forward<F>(factory));
+        }
+
+        template<typename F>
+        Handle get_or_load(const Key& key, F&& loader) {
+            return shard_for(key).get_or_load(key, std::forward<F>(loader));
+        }
+
+        bool contains(const Key& key) const {
+            return shard_for(key).contains(key);
+        }
+
+        bool erase(const Key& key) {
+            return shard_for(key).erase(key);
+        }
+
+        // 异构查找：分片选择与分片内查找都直接使用 K，不构造 Key
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        Handle get(const K& key) {
+            return shard_for(key).get(key);
+        }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        bool contains(const K& key) const {
+            return shard_for(key).contains(key);
+        }
+
+        template<typename K> requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+        bool erase(const K& key) {
+            return shard_for(key).erase(key);
+        }
+
+        void clear() {
+            for (auto& shard : shards) {
+                shard->clear();
+            }
+        }
+
+        // 依次推进各分片的时间轮，返回移除的过期条目总数
+        size_t tick(typename Clock::time_point now = Clock::now()) {
+            size_t expired = 0;
+            for (auto& shard : shards) {
+                expired += shard->tick(now);
+            }
+            return expired;
+        }
+
+        void set_default_ttl(typename Clock::duration ttl) noexcept {
+            for (auto& shard : shards) {
+                shard->set_default_ttl(ttl);
+            }
+        }
+
+        // 每个分片使用独立的频率草图，预期条目数按分片均分
+        void enable_admission_filter(size_t expectedEntries = 0) {
+            const size_t total = expectedEntries ? expectedEntries : maxSize;
+            for (auto& shard : shards) {
+                shard->enable_admission_filter((total + shards.size() - 1) / shards.size());
+            }
+        }
+
+        size_t admission_rejections() const {
+            size_t total = 0;
+            for (const auto& shard : shards) {
+                total += shard->admission_rejections();
+            }
+            return total;
+        }
+
+        // 每个分片使用独立的否定查找过滤器，预期键数按分片均分
+        void enable_negative_cache(size_t expectedAbsentKeys, double falsePositiveRate = 0.01) {
+            for (auto& shard : shards) {
+                shard->enable_negative_cache((expectedAbsentKeys + shards.size() - 1) / shards.size(),
+                                             falsePositiveRate);
+            }
+        }
+
+        size_t loader_calls_avoided() const {
+            size_t total = 0;
+            for (const auto& shard : shards) {
+                total += shard->loader_calls_avoided();
+            }
+            return total;
+        }
+
+        // 所有分片共用同一个监听器，会被多个线程并发调用
+        void set_eviction_listener(const EvictionListener& listener) {
+            for (auto& shard : shards) {
+                shard->set_eviction_listener(listener);
+            }
+        }
+
+        // 汇总所有分片的统计
+        CacheStats stats() const {
+            CacheStats total;
+            for (const auto& shard : shards) {
+                total.merge(shard->stats());
+            }
+            return total;
+        }
+
+        // 各分片分别加锁统计，并发修改时只是近似值
+        size_t size() const {
+            size_t total = 0;
+            for (const auto& shard : shards) {
+                total += shard->size();
+            }
+            return total;
+        }
+
+        size_t total_weight() const {
+            size_t total = 0;
+            for (const auto& shard : shards) {
+                total += shard->total_weight();
+            }
+            return total;
+        }
+
+        size_t capacity() const { return maxSize; }
+        size_t shard_count() const { return shards.size(); }
+    };
+
+}
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CACHE_SYSTEM_SNAPSHOT_MMAP 1
+#endif
+
+/**
+ * 缓存快照 - 热重启时保存与恢复缓存内容
+ *
+ * 文件格式（本机字节序，只保证在同一平台上读回）：
+ *   头部：8 字节魔数 "LRUSNAP1"、uint32 版本、uint32 保留、uint64 条目数
+ *   条目：int64 剩余 TTL（纳秒，0 表示不过期）、键、值
+ * 条目按最近使用顺序排列，最冷的在前，按文件顺序插入即可恢复原来的顺序。
+ *
+ * 键和值通过 Serializer<T> 读写。内置支持可平凡拷贝的类型、std::string
+ * 以及 std::vector；可平凡拷贝元素的 vector 作为一整块连续内存写入，
+ * 块起始位置按元素对齐，读回时从映射的文件直接整块拷贝。
+ * 其他值类型特化 Serializer<T> 提供 write(SnapshotWriter&, const T&)
+ * 与 read(SnapshotReader&)。
+ *
+ * 写入使用大块缓冲，读取时整个文件 mmap（不支持时一次顺序读入内存），
+ * 恢复速度受磁盘带宽限制。格式错误或文件截断时抛出 std::runtime_error。
+ * 写文件时先写入 path + ".tmp"，finish() 刷到磁盘后再 rename 覆盖目标文件：
+ * 保存中途出错或崩溃时，原来的快照保持完整。
+ *
+ * 两者也可以不关联文件：默认构造的 SnapshotWriter 把数据写入内存缓冲区，
+ * 以内存区间构造的 SnapshotReader 直接从该区间读取（都没有文件头），
+ * TieredCache 用它们在溢出文件中读写单个条目。
+ */
+namespace CacheSystem {
+
+    inline constexpr char kSnapshotMagic[8] = {'L', 'R', 'U', 'S', 'N', 'A', 'P', '1'};
+    inline constexpr uint32_t kSnapshotVersion = 1;
+
+    template<typename T>
+    struct Serializer;
+
+    class SnapshotWriter {
+    private:
+        static constexpr size_t kBufferSize = 1 << 20;
+
+        std::FILE* file = nullptr;
+        std::string path;
+        std::string tempPath;
+        std::vector<char> buffer;
+        size_t used = 0;
+        uint64_t offset = 0;  // 已写入的总字节数，用于对齐
+        uint64_t entries = 0;
+
+        void flush() {
+            if (!file) {
+                return;
+            }
+            if (used != 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+                throw std::runtime_error("写入快照失败: " + path);
+            }
+            used = 0;
+        }
+
+    public:
+        explicit SnapshotWriter(std::string filePath)
+            : path(std::move(filePath)), tempPath(path + ".tmp"), buffer(kBufferSize) {
+            file = std::fopen(tempPath.c_str(), "wb");
+            if (!file) {
+                throw std::runtime_error("无法创建快照文件: " + tempPath);
+            }
+            write_bytes(kSnapshotMagic, sizeof(kSnapshotMagic));
+            write(kSnapshotVersion);
+            write(uint32_t{0});
+            write(uint64_t{0});  // 条目数在 finish() 时回填
+        }
+
+        // 写入内存缓冲区，没有文件头，通过 bytes() 取出
+        SnapshotWriter() = default;
+
+        SnapshotWriter(const SnapshotWriter&) = delete;
+        SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+        // 没有 finish() 的写入被放弃：删除临时文件，目标文件不变
+        ~SnapshotWriter() {
+            if (file) {
+                std::fclose(file);
+                std::remove(tempPath.c_str());
+            }
+        }
+
+        void write_bytes(const void* data, size_t size) {
+            if (size == 0) {
+                return;  // 空 vector 的 data() 可能是空指针
+            }
+            offset += size;
+            if (!file) {
+                if (used + size > buffer.size()) {
+                    buffer.resize(std::max(buffer.size() * 2, used + size));
+                }
+                std::memcpy(buffer.data() + used, data, size);
+                used += size;
+                return;
+            }
+            if (size >= kBufferSize / 2) {
+                // 大块数据绕过缓冲直接写入
+                flush();
+                if (std::fwrite(data, 1, size, file) != size) {
+                    throw std::runtime_error("写入快照失败: " + path);
+                }
+                return;
+            }
+            if (used + size > buffer.size()) {
+                flush();
+            }
+            std::memcpy(buffer.data() + used, data, size);
+            used += size;
+        }
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        void write(const T& value) {
+            write_bytes(&value, sizeof(T));
+        }
+
+        // 填充零字节，使下一次写入的位置按 alignment 对齐
+        void align(size_t alignment) {
+            static constexpr char zeros[alignof(std::max_align_t)] = {};
+            size_t padding = (alignment - offset % alignment) % alignment;
+            // 超对齐的类型（如 alignas(64)）需要的填充可能比 zeros 长
+            while (padding > 0) {
+                const size_t chunk = std::min(padding, sizeof(zeros));
+                write_bytes(zeros, chunk);
+                padding -= chunk;
+            }
+        }
+
+        void begin_entry() noexcept { ++entries; }
+
+        // 回填条目数，把临时文件刷到磁盘并替换目标文件（只用于写文件）
+        void finish() {
+            if (!file) {
+                return;
+            }
+            flush();
+            const auto countOffset = static_cast<long>(sizeof(kSnapshotMagic) + 2 * sizeof(uint32_t));
+            if (std::fseek(file, countOffset, SEEK_SET) != 0 ||
+                std::fwrite(&entries, sizeof(entries), 1, file) != 1 || std::fflush(file) != 0) {
+                throw std::runtime_error("写入快照失败: " + tempPath);
+            }
+#ifdef CACHE_SYSTEM_SNAPSHOT_MMAP
+            if (::fsync(::fileno(file)) != 0) {
+                throw std::runtime_error("写入快照失败: " + tempPath);
+            }
+#endif
+            std::FILE* f = std::exchange(file, nullptr);
+            if (std::fclose(f) != 0 || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+                std::remove(tempPath.c_str());
+                throw std::runtime_error("写入快照失败: " + path);
+            }
+#ifdef CACHE_SYSTEM_SNAPSHOT_MMAP
+            // rename 本身也要落盘：同步目标文件所在的目录
+            const size_t slash = path.find_last_of('/');
+            const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+            if (int fd = ::open(dir.c_str(), O_RDONLY); fd >= 0) {
+                ::fsync(fd);
+                ::close(fd);
+            }
+#endif
+        }
+
+        uint64_t entry_count() const noexcept { return entries; }
+
+        // 写入内存时已写入的数据
+        std::span<const char> bytes() const noexcept { return {buffer.data(), used}; }
+
+        // 清空内存缓冲区以便复用（保留已分配的空间）
+        void clear() noexcept {
+            used = 0;
+            offset = 0;
+            entries = 0;
+        }
+    };
+
+    class SnapshotReader {
+    private:
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        size_t position = 0;
+        uint64_t entries = 0;
+        std::string path;
+#ifdef CACHE_SYSTEM_SNAPSHOT_MMAP
+        void* mapping = nullptr;
+#endif
+        std::vector<unsigned char> storage;  // 不支持 mmap 时的整文件缓冲
+
+        [[noreturn]] void corrupt() const {
+            throw std::runtime_error("快照文件损坏或被截断: " + path);
+        }
+
+        void open() {
+#ifdef CACHE_SYSTEM_SNAPSHOT_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("无法打开快照文件: " + path);
+            }
+            struct stat st{};
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("无法打开快照文件: " + path);
+            }
+            size = static_cast<size_t>(st.st_size);
+            if (size != 0) {
+                void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("无法映射快照文件: " + path);
+                }
+                ::madvise(p, size, MADV_SEQUENTIAL);
+                mapping = p;
+                data = static_cast<const unsigned char*>(p);
+            }
+            ::close(fd);
+#else
+            std::FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) {
+                throw std::runtime_error("无法打开快照文件: " + path);
+            }
+            std::fseek(file, 0, SEEK_END);
+            long length = std::ftell(file);
+            std::fseek(file, 0, SEEK_SET);
+            storage.resize(length > 0 ? static_cast<size_t>(length) : 0);
+            size_t got = std::fread(storage.data(), 1, storage.size(), file);
+            std::fclose(file);
+            if (got != storage.size()) {
+                throw std::runtime_error("读取快照失败: " + path);
+            }
+            data = storage.data();
+            size = storage.size();
+#endif
+        }
+
+    public:
+        explicit SnapshotReader(std::string filePath) : path(std::move(filePath)) {
+            open();
+            char magic[sizeof(kSnapshotMagic)];
+            read_bytes(magic, sizeof(magic));
+            if (std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 ||
+                read<uint32_t>() != kSnapshotVersion) {
+                throw std::runtime_error("不是受支持的快照文件: " + path);
+            }
+            read<uint32_t>();
+            entries = read<uint64_t>();
+        }
+
+        // 从一段内存读取（没有文件头），区间必须在读取期间保持有效
+        explicit SnapshotReader(std::span<const unsigned char> bytes)
+            : data(bytes.data()), size(bytes.size()), path("<内存>") {}
+
+        SnapshotReader(const SnapshotReader&) = delete;
+        SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+        ~SnapshotReader() {
+#ifdef CACHE_SYSTEM_SNAPSHOT_MMAP
+            if (mapping) {
+                ::munmap(mapping, size);
+            }
+#endif
+        }
+
+        // 返回接下来 count 字节在文件映射中的位置并前进
+        const unsigned char* consume(size_t count) {
+            if (count > size - position) {
+                corrupt();
+            }
+            const unsigned char* p = data + position;
+            position += count;
+            return p;
+        }
+
+        void read_bytes(void* out, size_t count) {
+            std::memcpy(out, consume(count), count);
+        }
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        T read() {
+            std::array<unsigned char, sizeof(T)> raw;
+            read_bytes(raw.data(), raw.size());
+            return std::bit_cast<T>(raw);
+        }
+
+        void align(size_t alignment) {
+            consume((alignment - position % alignment) % alignment);
+        }
+
+        // 对齐后的连续元素块，直接指向文件映射
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        std::span<const T> block(size_t count) {
+            align(alignof(T));
+            if (count > (size - position) / sizeof(T)) {
+                corrupt();
+            }
+            return {reinterpret_cast<const T*>(consume(count * sizeof(T))), count};
+        }
+
+        uint64_t entry_count() const noexcept { return entries; }
+        bool exhausted() const noexcept { return position == size; }
+    };
+
+    // 可平凡拷贝的类型按原始字节读写
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    struct Serializer<T> {
+        static void write(SnapshotWriter& out, const T& value) { out.write(value); }
+        static T read(SnapshotReader& in) { return in.read<T>(); }
+    };
+
+    template<>
+    struct Serializer<std::string> {
+        static void write(SnapshotWriter& out, const std::string& value) {
+            out.write(static_cast<uint64_t>(value.size()));
+            out.write_bytes(value.data(), value.size());
+        }
+
+        static std::string read(SnapshotReader& in) {
+            auto length = in.read<uint64_t>();
+            auto chars = in.block<char>(length);
+            return std::string(chars.begin(), chars.end());
+        }
+    };
+
+    template<typename T>
+    struct Serializer<std::vector<T>> {
+        static void write(SnapshotWriter& out, const std::vector<T>& value) {
+            out.write(static_cast<uint64_t>(value.size()));
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                out.align(alignof(T));
+                out.write_bytes(value.data(), value.size() * sizeof(T));
+            } else {
+                for (const auto& element : value) {
+                    Serializer<T>::write(out, element);
+                }
+            }
+        }
+
+        static std::vector<T> read(SnapshotReader& in) {
+            auto count = in.read<uint64_t>();
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                auto elements = in.block<T>(count);
+                return std::vector<T>(elements.begin(), elements.end());
+            } else {
+                std::vector<T> result;
+                for (uint64_t i = 0; i < count; ++i) {
+                    result.push_back(Serializer<T>::read(in));
+                }
+                return result;
+            }
+        }
+    };
+
+}
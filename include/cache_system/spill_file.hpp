@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define CACHE_SYSTEM_SPILL_MMAP 1
+#endif
+
+/**
+ * 溢出文件 - TieredCache 的第二层存储
+ *
+ * 固定大小的本地文件整体映射到内存，记录只在末尾追加：
+ *   记录头：uint64 键哈希、uint32 负载长度、uint32 保留；负载为序列化后的键和值
+ *   每条记录按 16 字节对齐，负载中的数据块可以直接在映射上按类型对齐读取
+ * 内存中只保留紧凑的索引（键哈希 -> 记录偏移，每个条目 16 字节，线性探测），
+ * 键本身只存在文件里，查找命中后由调用者比较记录中的键。
+ * find() 返回直接指向映射的负载区间，读取时没有额外的拷贝。
+ *
+ * 覆盖或删除只让旧记录失效（计入 deadBytes），空间由压缩回收：
+ * 文件写满时按文件顺序把有效记录向前搬移（原地 memmove，目标总在源之前），
+ * 有效数据超过容量的 3/4 时顺带丢弃最旧的记录，因此整体上是一个 FIFO 的第二层。
+ * 压缩会移动记录，之前 find() 返回的区间随之失效。
+ *
+ * 文件在构造时创建并预留空间，析构时删除：它只是缓存，不用于持久化。
+ * 不支持 mmap 的平台上退化为同样大小的堆内存。非线程安全。
+ */
+namespace CacheSystem {
+
+    class SpillFile {
+    private:
+        static constexpr size_t kAlignment = 16;
+        static constexpr uint64_t kEmpty = ~uint64_t{0};
+
+        struct RecordHeader {
+            uint64_t hash;
+            uint32_t length;
+            uint32_t reserved;
+        };
+        static_assert(sizeof(RecordHeader) == kAlignment);
+
+        // 索引槽位：offset 为 kEmpty 表示空
+        struct Slot {
+            uint64_t hash;
+            uint64_t offset;
+        };
+
+        std::string path;
+        unsigned char* base = nullptr;
+        size_t capacity;
+        size_t tail = 0;        // 下一条记录的写入位置
+        size_t liveBytes = 0;
+        size_t deadBytes = 0;
+        size_t compactions = 0;
+        std::vector<Slot> slots;
+        size_t count = 0;
+#ifdef CACHE_SYSTEM_SPILL_MMAP
+        int fd = -1;
+#else
+        std::unique_ptr<unsigned char[]> heap;
+#endif
+
+        static size_t mix(uint64_t hash) noexcept {
+            uint64_t h = hash * 0x9e3779b97f4a7c15ULL;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+
+        static size_t record_size(size_t length) noexcept {
+            return sizeof(RecordHeader) + (length + kAlignment - 1) / kAlignment * kAlignment;
+        }
+
+        const RecordHeader& header_at(size_t offset) const noexcept {
+            return *reinterpret_cast<const RecordHeader*>(base + offset);
+        }
+
+        size_t mask() const noexcept { return slots.size() - 1; }
+
+        // hash 所在的槽位，没有时返回 slots.size()
+        size_t slot_of(uint64_t hash) const noexcept {
+            for (size_t i = mix(hash) & mask();; i = (i + 1) & mask()) {
+                if (slots[i].offset == kEmpty) {
+                    return slots.size();
+                }
+                if (slots[i].hash == hash) {
+                    return i;
+                }
+            }
+        }
+
+        void index_insert(uint64_t hash, uint64_t offset) {
+            if ((count + 1) * 4 > slots.size() * 3) {
+                std::vector<Slot> old = std::exchange(slots, std::vector<Slot>(slots.size() * 2, Slot{0, kEmpty}));
+                for (const Slot& slot : old) {
+                    if (slot.offset != kEmpty) {
+                        place(slot);
+                    }
+                }
+            }
+            place({hash, offset});
+            ++count;
+        }
+
+        void place(Slot slot) noexcept {
+            size_t i = mix(slot.hash) & mask();
+            while (slots[i].offset != kEmpty) {
+                i = (i + 1) & mask();
+            }
+            slots[i] = slot;
+        }
+
+        // 线性探测的后移删除：把后面探测链上的槽位补到空位上，不留墓碑
+        void index_erase(size_t i) noexcept {
+            slots[i].offset = kEmpty;
+            --count;
+            for (size_t j = (i + 1) & mask(); slots[j].offset != kEmpty; j = (j + 1) & mask()) {
+                size_t home = mix(slots[j].hash) & mask();
+                // j 的理想位置不在 (i, j] 区间内时，移到 i 不会破坏它的探测链
+                if (((j - home) & mask()) >= ((j - i) & mask())) {
+                    slots[i] = slots[j];
+                    slots[j].offset = kEmpty;
+                    i = j;
+                }
+            }
+        }
+
+        void map_file() {
+#ifdef CACHE_SYSTEM_SPILL_MMAP
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+            if (fd < 0) {
+                throw std::runtime_error("无法创建溢出文件: " + path);
+            }
+            // 预先分配磁盘空间，避免写入映射时因磁盘已满收到 SIGBUS
+            int rc = EINVAL;
+#if defined(__linux__)
+            rc = ::posix_fallocate(fd, 0, static_cast<off_t>(capacity));
+#endif
+            if (rc != 0 && ::ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+                ::close(fd);
+                ::unlink(path.c_str());
+                throw std::runtime_error("无法为溢出文件分配空间: " + path);
+            }
+            void* p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                ::unlink(path.c_str());
+                throw std::runtime_error("无法映射溢出文件: " + path);
+            }
+            base = static_cast<unsigned char*>(p);
+#else
+            heap = std::make_unique<unsigned char[]>(capacity);
+            base = heap.get();
+#endif
+        }
+
+    public:
+        SpillFile(std::string filePath, size_t capacityBytes)
+            : path(std::move(filePath)),
+              capacity(capacityBytes / kAlignment * kAlignment),
+              slots(64, Slot{0, kEmpty}) {
+            map_file();
+        }
+
+        SpillFile(const SpillFile&) = delete;
+        SpillFile& operator=(const SpillFile&) = delete;
+
+        ~SpillFile() {
+#ifdef CACHE_SYSTEM_SPILL_MMAP
+            ::munmap(base, capacity);
+            ::close(fd);
+            ::unlink(path.c_str());
+#endif
+        }
+
+        /**
+         * 追加一条记录，同一哈希的旧记录随之失效；空间不足时先压缩
+         * 单条记录超过文件容量时不写入，返回 false
+         */
+        bool append(uint64_t hash, std::span<const char> payload) {
+            const size_t size = record_size(payload.size());
+            erase(hash);
+            if (size > capacity || payload.size() > UINT32_MAX) {
+                return false;
+            }
+            if (tail + size > capacity) {
+                compact(size);
+            }
+            RecordHeader header{hash, static_cast<uint32_t>(payload.size()), 0};
+            index_insert(hash, tail);
+            std::memcpy(base + tail, &header, sizeof(header));
+            std::memcpy(base + tail + sizeof(header), payload.data(), payload.size());
+            tail += size;
+            liveBytes += size;
+            return true;
+        }
+
+        // hash 对应记录的负载，直接指向映射；没有时返回空区间
+        std::span<const unsigned char> find(uint64_t hash) const noexcept {
+            size_t i = slot_of(hash);
+            if (i == slots.size()) {
+                return {};
+            }
+            const size_t offset = slots[i].offset;
+            return {base + offset + sizeof(RecordHeader), header_at(offset).length};
+        }
+
+        bool erase(uint64_t hash) noexcept {
+            size_t i = slot_of(hash);
+            if (i == slots.size()) {
+                return false;
+            }
+            const size_t size = record_size(header_at(slots[i].offset).length);
+            liveBytes -= size;
+            deadBytes += size;
+            index_erase(i);
+            return true;
+        }
+
+        /**
+         * 压缩：按文件顺序把有效记录搬到前面，回收失效记录的空间
+         * 压缩后还要放入 reserve 字节；有效数据超过容量的 3/4 时先丢弃最旧的记录
+         */
+        void compact(size_t reserve = 0) {
+            const size_t limit = capacity / 4 * 3;
+            size_t toDrop = liveBytes + reserve > limit ? liveBytes + reserve - limit : 0;
+            size_t write = 0;
+            for (size_t read = 0; read < tail;) {
+                const RecordHeader header = header_at(read);
+                const size_t size = record_size(header.length);
+                size_t i = slot_of(header.hash);
+                if (i != slots.size() && slots[i].offset == read) {
+                    if (toDrop > 0) {
+                        toDrop -= std::min(toDrop, size);
+                        liveBytes -= size;
+                        index_erase(i);
+                    } else {
+                        if (write != read) {
+                            std::memmove(base + write, base + read, size);
+                            slots[i].offset = write;
+                        }
+                        write += size;
+                    }
+                }
+                read += size;
+            }
+            tail = write;
+            deadBytes = 0;
+            ++compactions;
+        }
+
+        void clear() noexcept {
+            std::fill(slots.begin(), slots.end(), Slot{0, kEmpty});
+            count = 0;
+            tail = 0;
+            liveBytes = 0;
+            deadBytes = 0;
+        }
+
+        size_t size() const noexcept { return count; }
+        size_t live_bytes() const noexcept { return liveBytes; }
+        size_t dead_bytes() const noexcept { return deadBytes; }
+        size_t capacity_bytes() const noexcept { return capacity; }
+        size_t compaction_count() const noexcept { return compactions; }
+
+        // 内存索引占用的字节数
+        size_t index_memory() const noexcept { return slots.size() * sizeof(Slot); }
+    };
+
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) && !defined(CACHE_SYSTEM_SWISS_SCALAR)
+#include <emmintrin.h>
+#define CACHE_SYSTEM_SWISS_SSE2 1
+#endif
+
+/**
+ * Swiss table 式的开放寻址索引 - LRUCache 的键索引
+ *
+ * 元素是节点指针，节点自身缓存了键的哈希值 (node->hash)。哈希打散后分两部分：
+ * 高位 (H1) 决定从哪个组开始探测，低 7 位 (H2) 作为 1 字节标签。
+ * 控制字节与槽位分开存放：每 16 个槽位对应一个 16 字节对齐的控制组，
+ * 探测时用 SSE2 一条比较指令同时比较 16 个标签（无 SSE2 时逐字节比较，
+ * 定义 CACHE_SYSTEM_SWISS_SCALAR 可强制使用标量实现）。
+ * 标签命中后才读取槽位并解引用节点比较键，因此一次成功的查找通常只访问
+ * 一个控制组（1 MB/百万条目，常驻缓存）、一个槽位和目标节点本身，
+ * 不会像链式哈希表那样沿着桶链表逐个访问节点。
+ *
+ * 控制字节：0x80 空，0xFE 已删除（墓碑），0x00-0x7F 为占用槽位的 H2 标签。
+ * 组间按三角数序列探测；装载因子上限 7/8，保证每条探测序列都能遇到空槽。
+ * 删除时若所在组仍有空槽则直接置空，否则留下墓碑，墓碑在扩容或原地重建时清除。
+ */
+namespace CacheSystem {
+
+    template<typename Node>
+    class SwissIndex {
+    private:
+        static constexpr size_t kGroupSize = 16;
+        static constexpr int8_t kEmpty = static_cast<int8_t>(0x80);
+        static constexpr int8_t kDeleted = static_cast<int8_t>(0xFE);
+
+        struct alignas(kGroupSize) Group {
+            int8_t ctrl[kGroupSize];
+        };
+
+        std::vector<Group> groups;
+        std::vector<Node*> slots;
+        size_t groupMask = 0;
+        size_t count = 0;
+        size_t tombstones = 0;
+        size_t growthLeft = 0;  // 不需要扩容还能占用的空槽数
+
+        // 打散哈希：std::hash 对整数是恒等映射，低位和高位都需要充分混合
+        static size_t mix(size_t hash) noexcept {
+            uint64_t h = static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+
+        static size_t h1(size_t mixed) noexcept { return mixed >> 7; }
+        static int8_t h2(size_t mixed) noexcept { return static_cast<int8_t>(mixed & 0x7f); }
+
+        // 组内等于 tag 的槽位掩码，第 i 位对应第 i 个槽位
+        static uint32_t match(const Group& group, int8_t tag) noexcept {
+#ifdef CACHE_SYSTEM_SWISS_SSE2
+            __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group.ctrl));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupSize; ++i) {
+                mask |= static_cast<uint32_t>(group.ctrl[i] == tag) << i;
+            }
+            return mask;
+#endif
+        }
+
+        // 空槽或墓碑（控制字节最高位为 1）的掩码
+        static uint32_t match_free(const Group& group) noexcept {
+#ifdef CACHE_SYSTEM_SWISS_SSE2
+            __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group.ctrl));
+            return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupSize; ++i) {
+                mask |= static_cast<uint32_t>(group.ctrl[i] < 0) << i;
+            }
+            return mask;
+#endif
+        }
+
+        static bool has_empty(const Group& group) noexcept { return match(group, kEmpty) != 0; }
+
+        size_t capacity() const noexcept { return slots.size(); }
+
+        // 按探测序列寻找 node 所在的槽位，没有时返回 capacity()
+        size_t slot_of(const Node* node) const noexcept {
+            if (groups.empty()) {
+                return capacity();
+            }
+            const size_t mixed = mix(node->hash);
+            const int8_t tag = h2(mixed);
+            size_t g = h1(mixed) & groupMask;
+            for (size_t step = 1;; ++step) {
+                const Group& group = groups[g];
+                for (uint32_t m = match(group, tag); m != 0; m &= m - 1) {
+                    size_t slot = g * kGroupSize + static_cast<size_t>(std::countr_zero(m));
+                    if (slots[slot] == node) {
+                        return slot;
+                    }
+                }
+                if (has_empty(group)) {
+                    return capacity();
+                }
+                g = (g + step) & groupMask;
+            }
+        }
+
+        // 不检查重复地放入一个节点，调用者保证还有空余
+        void place(Node* node) noexcept {
+            const size_t mixed = mix(node->hash);
+            size_t g = h1(mixed) & groupMask;
+            for (size_t step = 1;; ++step) {
+                uint32_t available = match_free(groups[g]);
+                if (available != 0) {
+                    size_t i = static_cast<size_t>(std::countr_zero(available));
+                    int8_t& ctrl = groups[g].ctrl[i];
+                    if (ctrl == kEmpty) {
+                        --growthLeft;
+                    } else {
+                        --tombstones;
+                    }
+                    ctrl = h2(mixed);
+                    slots[g * kGroupSize + i] = node;
+                    ++count;
+                    return;
+                }
+                g = (g + step) & groupMask;
+            }
+        }
+
+        // 重建为 groupCount 个组（2 的幂），同时清除所有墓碑
+        void rehash(size_t groupCount) {
+            std::vector<Group> newGroups(groupCount);
+            std::vector<Node*> newSlots(groupCount * kGroupSize, nullptr);
+            for (auto& group : newGroups) {
+                std::memset(group.ctrl, static_cast<unsigned char>(kEmpty), kGroupSize);
+            }
+            std::vector<Group> oldGroups = std::exchange(groups, std::move(newGroups));
+            std::vector<Node*> oldSlots = std::exchange(slots, std::move(newSlots));
+
+            groupMask = groupCount - 1;
+            count = 0;
+            tombstones = 0;
+            growthLeft = capacity() - capacity() / 8;
+            for (size_t g = 0; g < oldGroups.size(); ++g) {
+                for (size_t i = 0; i < kGroupSize; ++i) {
+                    if (oldGroups[g].ctrl[i] >= 0) {
+                        place(oldSlots[g * kGroupSize + i]);
+                    }
+                }
+            }
+        }
+
+        static size_t groups_for(size_t entries) noexcept {
+            // 装载因子不超过 7/8
+            size_t needed = entries + entries / 7 + 1;
+            size_t groupCount = 1;
+            while (groupCount * kGroupSize < needed) {
+                groupCount <<= 1;
+            }
+            return groupCount;
+        }
+
+    public:
+        SwissIndex() = default;
+
+        SwissIndex(const SwissIndex&) = delete;
+        SwissIndex& operator=(const SwissIndex&) = delete;
+
+        // matches(const Node*) 在标签命中时判断键是否相等
+        template<typename Matches>
+        Node* find(size_t hash, Matches&& matches) const {
+            if (groups.empty()) {
+                return nullptr;
+            }
+            const size_t mixed = mix(hash);
+            const int8_t tag = h2(mixed);
+            size_t g = h1(mixed) & groupMask;
+            for (size_t step = 1;; ++step) {
+                const Group& group = groups[g];
+                for (uint32_t m = match(group, tag); m != 0; m &= m - 1) {
+                    Node* node = slots[g * kGroupSize + static_cast<size_t>(std::countr_zero(m))];
+                    if (matches(static_cast<const Node*>(node))) {
+                        return node;
+                    }
+                }
+                if (has_empty(group)) {
+                    return nullptr;
+                }
+                g = (g + step) & groupMask;
+            }
+        }
+
+        // 放入一个索引中还没有的节点；需要扩容时重建（强异常保证）
+        void insert(Node* node) {
+            if (growthLeft == 0) {
+                // 墓碑占比较高时原地重建即可，否则容量翻倍
+                size_t groupCount = groups.empty() ? 1 : groups.size();
+                if (tombstones <= capacity() / 16) {
+                    groupCount = groups_for(count + 1);
+                    if (groupCount <= groups.size()) {
+                        groupCount = groups.size() * 2;
+                    }
+                }
+                rehash(groupCount);
+            }
+            place(node);
+        }
+
+        // 移除节点，节点不在索引中时返回 false
+        bool erase(const Node* node) noexcept {
+            size_t slot = slot_of(node);
+            if (slot == capacity()) {
+                return false;
+            }
+            Group& group = groups[slot / kGroupSize];
+            // 组内仍有空槽说明从没有探测序列越过这个组，可以直接置空
+            if (has_empty(group)) {
+                group.ctrl[slot % kGroupSize] = kEmpty;
+                ++growthLeft;
+            } else {
+                group.ctrl[slot % kGroupSize] = kDeleted;
+                ++tombstones;
+            }
+            slots[slot] = nullptr;
+            --count;
+            return true;
+        }
+
+        void reserve(size_t entries) {
+            size_t groupCount = groups_for(entries);
+            if (groupCount > groups.size()) {
+                rehash(groupCount);
+            }
+        }
+
+        // 预取 hash 的第一个探测组及其槽位，供批量查找提前发起内存访问
+        void prefetch(size_t hash) const noexcept {
+            if (groups.empty()) {
+                return;
+            }
+            size_t g = h1(mix(hash)) & groupMask;
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(&groups[g]);
+            __builtin_prefetch(&slots[g * kGroupSize]);
+#endif
+        }
+
+        template<typename F>
+        void for_each(F&& f) const {
+            for (size_t g = 0; g < groups.size(); ++g) {
+                for (size_t i = 0; i < kGroupSize; ++i) {
+                    if (groups[g].ctrl[i] >= 0) {
+                        f(slots[g * kGroupSize + i]);
+                    }
+                }
+            }
+        }
+
+        size_t size() const noexcept { return count; }
+        bool empty() const noexcept { return count == 0; }
+
+        // 控制字节与槽位数组占用的字节数
+        size_t memory_usage() const noexcept {
+            return groups.size() * sizeof(Group) + slots.size() * sizeof(Node*);
+        }
+    };
+
+}
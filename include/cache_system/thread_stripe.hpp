@@ -0,0 +1,25 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * 线程条带编号 - 按线程分散共享计数器，避免读者之间争用同一条缓存行
+ *
+ * 每个线程第一次调用时从全局计数器领取一个编号，之后固定不变；
+ * 使用者按 thread_stripe() & (条带数 - 1) 选择自己的条带。
+ */
+namespace CacheSystem {
+
+    namespace detail {
+
+        // 每个线程固定使用的条带编号（所有缓存共用）
+        inline size_t thread_stripe() noexcept {
+            static std::atomic<size_t> next{0};
+            thread_local const size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+            return stripe;
+        }
+
+    }
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "cache_system/lru_cache.hpp"
+#include "cache_system/snapshot.hpp"
+#include "cache_system/spill_file.hpp"
+
+/**
+ * 两层缓存 - 内存中的 LRUCache + 映射到本地文件的溢出层
+ *
+ * 1. 第一层是普通的 LRUCache；被容量淘汰的条目通过淘汰监听器序列化
+ *    （Serializer<Key> / Serializer<Value>，与快照相同）后追加到溢出文件
+ * 2. 第一层未命中时查溢出文件：内存索引只有键哈希到记录偏移，命中后直接在
+ *    文件映射上反序列化（可平凡拷贝元素的 vector 等数据块从映射整块读取，
+ *    没有中间缓冲区），比较键之后把条目提升回第一层并从溢出文件中移除
+ * 3. put 会让溢出文件中同一个键的旧值失效，任何时刻一个键只有一个有效版本
+ * 4. 溢出文件写满时压缩回收失效记录的空间，仍然放不下时丢弃最旧的记录，
+ *    也可以在空闲时调用 compact() 主动压缩
+ *
+ * 第二层的容量以字节计，通常是第一层的许多倍（例如把 10 倍于工作集的数据
+ * 放在本地 SSD 上）。不支持 TTL（过期条目不应写入溢出层）。
+ * 与默认的 LRUCache 一样非线程安全；Handle 不能比缓存活得更久。
+ */
+namespace CacheSystem {
+
+    template<typename Key, typename Value,
+             template<typename> class Policy = LRUPolicy,
+             typename Hash = typename detail::DefaultLookup<Key>::Hash,
+             typename KeyEqual = typename detail::DefaultLookup<Key>::KeyEqual>
+    class TieredCache {
+    public:
+        using MemoryCache = LRUCache<Key, Value, Policy, Hash, KeyEqual>;
+        using Handle = typename MemoryCache::Handle;
+
+    private:
+        // 溢出文件必须比第一层活得更久：第一层析构时不再通知监听器，但仍先析构它
+        SpillFile spill;
+        SnapshotWriter scratch;  // 序列化被淘汰条目的复用缓冲区
+        Hash hasher;
+        KeyEqual equal;
+        size_t spillHits = 0;
+        size_t spillWrites = 0;
+        MemoryCache memory;
+
+        void spill_entry(const Key& key, const Value& value) {
+            scratch.clear();
+            Serializer<Key>::write(scratch, key);
+            Serializer<Value>::write(scratch, value);
+            if (spill.append(hasher(key), scratch.bytes())) {
+                ++spillWrites;
+            }
+        }
+
+        // 在溢出文件中查找 key，命中时以定位到值的读取器调用 f；
+        // 哈希相同但键不同的记录视为未命中
+        template<typename F>
+        bool with_record(const Key& key, uint64_t hash, F&& f) const {
+            auto record = spill.find(hash);
+            if (record.empty()) {
+                return false;
+            }
+            SnapshotReader in(record);
+            if (!equal(Serializer<Key>::read(in), key)) {
+                return false;
+            }
+            f(in);
+            return true;
+        }
+
+        // 从溢出文件读回 key 的值并提升到第一层，不在溢出文件中时返回 false
+        bool promote(const Key& key) {
+            const uint64_t hash = hasher(key);
+            std::optional<Value> value;
+            if (!with_record(key, hash, [&](SnapshotReader& in) { value.emplace(Serializer<Value>::read(in)); })) {
+                return false;
+            }
+            // 先移除记录再插入：插入可能淘汰其他条目并触发压缩，移动文件中的记录
+            spill.erase(hash);
+            memory.put(key, std::move(*value));
+            ++spillHits;
+            return true;
+        }
+
+    public:
+        // memoryCapacity 为第一层条目数，spillBytes 为溢出文件大小（字节）
+        TieredCache(size_t memoryCapacity, std::string spillPath, size_t spillBytes)
+            : spill(std::move(spillPath), spillBytes), memory(memoryCapacity) {
+            memory.set_eviction_listener([this](Key&& key, Value&& value) {
+                spill_entry(key, value);
+            });
+        }
+
+        TieredCache(const TieredCache&) = delete;
+        TieredCache& operator=(const TieredCache&) = delete;
+
+        template<typename K, typename V>
+        void put(K&& key, V&& value) {
+            Key k(std::forward<K>(key));
+            spill.erase(hasher(k));
+            memory.put(std::move(k), std::forward<V>(value));
+        }
+
+        // 先查第一层，未命中时查溢出文件并提升
+        Handle get(const Key& key) {
+            if (Handle handle = memory.get(key)) {
+                return handle;
+            }
+            return promote(key) ? memory.get(key) : Handle();
+        }
+
+        bool contains(const Key& key) const {
+            return memory.contains(key) || with_record(key, hasher(key), [](SnapshotReader&) {});
+        }
+
+        bool erase(const Key& key) {
+            bool erased = memory.erase(key);
+            const uint64_t hash = hasher(key);
+            if (with_record(key, hash, [](SnapshotReader&) {})) {
+                spill.erase(hash);
+                erased = true;
+            }
+            return erased;
+        }
+
+        void clear() {
+            memory.clear();
+            spill.clear();
+        }
+
+        // 压缩溢出文件，回收失效记录占用的空间
+        void compact() { spill.compact(); }
+
+        void print_cache() const { memory.print_cache(); }
+
+        CacheStats stats() const noexcept { return memory.stats(); }
+
+        size_t size() const { return memory.size(); }
+        size_t spilled() const noexcept { return spill.size(); }
+        size_t spill_hits() const noexcept { return spillHits; }
+        size_t spill_writes() const noexcept { return spillWrites; }
+        size_t spill_live_bytes() const noexcept { return spill.live_bytes(); }
+        size_t spill_dead_bytes() const noexcept { return spill.dead_bytes(); }
+        size_t spill_compactions() const noexcept { return spill.compaction_count(); }
+        size_t capacity() const { return memory.capacity(); }
+    };
+
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 分层时间轮 - 驱动缓存条目的 TTL 过期
+ *
+ * 5 层，每层 64 个桶；第 0 层每个桶覆盖 2^24 ns (约 16.8 ms)，每往上一层
+ * 桶宽扩大 64 倍（约 1.07 s、68.7 s、73 min、78 h）。条目按剩余时间放入
+ * 能容纳它的最低一层，桶位置由绝对到期时间决定。
+ *
+ * 时间推进时，每一层只处理从上次时间到当前时间之间经过的桶（最多 64 个）：
+ * 已到期的条目交给回调淘汰，未到期的条目重新放入更低的层。
+ * 每个条目在整个生命周期内最多被移动"层数"次，调度、取消、过期均摊 O(1)，
+ * 推进时不会遍历整个缓存。
+ *
+ * 条目通过侵入式的 TimerHook 挂在桶上，不额外分配内存。
+ */
+namespace CacheSystem {
+
+    namespace detail {
+
+        // 时间轮使用的节点挂钩，与淘汰策略的链表相互独立
+        struct TimerHook {
+            TimerHook* timerPrev = this;
+            TimerHook* timerNext = this;
+            int64_t expireAt = 0;  // steady_clock 纳秒，0 表示永不过期
+
+            bool scheduled() const noexcept { return timerNext != this; }
+
+            void timer_unlink() noexcept {
+                timerPrev->timerNext = timerNext;
+                timerNext->timerPrev = timerPrev;
+                timerPrev = timerNext = this;
+            }
+
+            void timer_push(TimerHook* hook) noexcept {
+                hook->timerPrev = timerPrev;
+                hook->timerNext = this;
+                timerPrev->timerNext = hook;
+                timerPrev = hook;
+            }
+        };
+
+        inline int64_t steady_now_ns() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    }
+
+    template<typename Node>
+    class TimerWheel {
+    private:
+        static constexpr int kLevels = 5;
+        static constexpr int kBuckets = 64;
+        static constexpr int kBaseShift = 24;
+        static constexpr int kLevelShift = 6;
+
+        std::array<std::array<detail::TimerHook, kBuckets>, kLevels> wheel;
+        int64_t current;
+
+        static constexpr int shift_of(int level) noexcept {
+            return kBaseShift + level * kLevelShift;
+        }
+
+        detail::TimerHook& bucket_for(int64_t expireAt) noexcept {
+            int64_t time = std::max(expireAt, current);
+            int64_t duration = time - current;
+            for (int level = 0; level < kLevels - 1; ++level) {
+                if (duration < (int64_t{1} << shift_of(level + 1))) {
+                    return wheel[level][(time >> shift_of(level)) & (kBuckets - 1)];
+                }
+            }
+            return wheel[kLevels - 1][(time >> shift_of(kLevels - 1)) & (kBuckets - 1)];
+        }
+
+    public:
+        explicit TimerWheel(int64_t nowNs) : current(nowNs) {}
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        void schedule(Node* node) noexcept {
+            node->timer_unlink();
+            if (node->expireAt != 0) {
+                bucket_for(node->expireAt).timer_push(node);
+            }
+        }
+
+        void deschedule(Node* node) noexcept { node->timer_unlink(); }
+
+        // 推进到 nowNs，对每个已到期的条目调用 onExpire(Node*)，返回到期条目数
+        template<typename F>
+        size_t advance(int64_t nowNs, F&& onExpire) {
+            const int64_t previous = current;
+            if (nowNs <= previous) {
+                return 0;
+            }
+            current = nowNs;
+
+            size_t expired = 0;
+            for (int level = 0; level < kLevels; ++level) {
+                const int64_t prevTicks = previous >> shift_of(level);
+                const int64_t delta = (nowNs >> shift_of(level)) - prevTicks;
+                if (delta <= 0) {
+                    break;
+                }
+                const int64_t count = std::min<int64_t>(delta + 1, kBuckets);
+                for (int64_t i = 0; i < count; ++i) {
+                    auto& sentinel = wheel[level][(prevTicks + i) & (kBuckets - 1)];
+                    // 先把整个桶摘到临时链表上，避免重新调度的条目回到正在处理的桶
+                    detail::TimerHook pending;
+                    while (sentinel.scheduled()) {
+                        detail::TimerHook* hook = sentinel.timerNext;
+                        hook->timer_unlink();
+                        pending.timer_push(hook);
+                    }
+                    while (pending.scheduled()) {
+                        auto* node = static_cast<Node*>(pending.timerNext);
+                        node->timer_unlink();
+                        if (node->expireAt <= nowNs) {
+                            ++expired;
+                            onExpire(node);
+                        } else {
+                            schedule(node);
+                        }
+                    }
+                }
+            }
+            return expired;
+        }
+    };
+
+}
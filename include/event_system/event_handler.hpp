@@ -0,0 +1,227 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "event_system/mpsc_queue.hpp"
+
+/**
+ * 事件处理器 - 按事件类型编号分派
+ *
+ * 设计要点：
+ * 1. 每个事件类型第一次使用时领取一个连续的小整数编号（event_type_id<E>()），
+ *    具体事件类型从 EventOf<E> 派生，构造时把自己的编号记录在 Event 中；
+ *    类型名只在静态名称表中存一份，getType() 按编号查表返回 string_view
+ * 2. on<E>(handler) 把处理函数登记在以编号为下标的表中；process_events
+ *    对每个事件只做一次数组下标查找和一次间接调用，不使用 dynamic_cast，
+ *    耗时与事件类型的数量无关，增加事件类型不会拖慢其他类型
+ * 3. 处理函数收到的是具体类型的引用：事件的编号保证了它的动态类型，
+ *    static_cast 是安全的
+ * 4. 没有登记处理函数的事件类型被直接丢弃；同一类型重复登记时替换原来的处理函数
+ * 5. 事件队列是侵入式 MPSC 队列（mpsc_queue.hpp）：emplace_event / add_event 可以
+ *    从任意多个线程同时调用，入队是一次 exchange，不加锁、不重试，链接指针在 Event
+ *    内部，不额外分配节点；process_events 在唯一的消费者线程上成批取出事件
+ * 6. process_events(maxEvents, timeBudget) 限制一次处理的事件数和时间，先到者为准，
+ *    让持有事件处理器的帧循环 / 请求循环不会被一次突发的大量事件长时间阻塞；
+ *    每处理 kClockCheckInterval 个事件才读一次时钟
+ *
+ * on 与 process_events 只能在消费者线程上调用（on 通常在生产者启动前完成）。
+ */
+namespace EventSystem {
+
+    using EventTypeId = uint16_t;
+
+    // 事件类型数的上限（名称表的大小）
+    inline constexpr size_t kMaxEventTypes = 4096;
+
+    namespace detail {
+
+        // 名称表：以 EventTypeId 为下标，指向各事件类型自己的静态 string_view。
+        // 登记可能发生在多个生产者线程上，表项是原子指针，读取不加锁
+        inline std::atomic<const std::string_view*> event_type_names[kMaxEventTypes];
+
+        template<typename E>
+        constexpr std::string_view type_name() noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+            // "... type_name() [with E = EventSystem::MouseEvent; ...]" 或 "... [E = EventSystem::MouseEvent]"
+            std::string_view name = __PRETTY_FUNCTION__;
+            name.remove_prefix(name.find("E = ") + 4);
+            return name.substr(0, name.find_first_of(";]"));
+#else
+            return "Event";
+#endif
+        }
+
+        template<typename E>
+        constexpr std::string_view event_name() noexcept {
+            if constexpr (requires { { E::kEventName } -> std::convertible_to<std::string_view>; }) {
+                return E::kEventName;
+            } else {
+                return type_name<E>();
+            }
+        }
+
+        inline EventTypeId register_event_type(const std::string_view* name) {
+            static std::atomic<size_t> next{0};
+            // 只在未满时递增：抛出异常的静态初始化会在下次调用时重试，计数不能因此一直增长
+            size_t id = next.load(std::memory_order_relaxed);
+            do {
+                if (id >= kMaxEventTypes) {
+                    throw std::length_error("事件类型数超过 kMaxEventTypes");
+                }
+            } while (!next.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+            event_type_names[id].store(name, std::memory_order_release);
+            return static_cast<EventTypeId>(id);
+        }
+
+    }
+
+    // 事件类型 E 的编号：进程内固定，从 0 开始连续分配。
+    // 名称取 E::kEventName（若定义），否则取编译器给出的类型名
+    template<typename E>
+    EventTypeId event_type_id() {
+        static constexpr std::string_view name = detail::event_name<E>();
+        static const EventTypeId id = detail::register_event_type(&name);
+        return id;
+    }
+
+    // 编号对应的事件类型名（诊断用）；未登记的编号返回空
+    inline std::string_view event_type_name(EventTypeId id) noexcept {
+        if (id >= kMaxEventTypes) {
+            return {};
+        }
+        const std::string_view* name = detail::event_type_names[id].load(std::memory_order_acquire);
+        return name ? *name : std::string_view{};
+    }
+
+    // 事件基类：除虚表指针与队列链接外只有时间戳和 2 字节的类型编号，
+    // 构造、移动和析构都不分配内存，也不输出日志
+    class Event : public MpscNode {
+    private:
+        std::chrono::steady_clock::time_point timestamp;
+        EventTypeId typeId;
+
+    protected:
+        explicit Event(EventTypeId id) noexcept : timestamp(std::chrono::steady_clock::now()), typeId(id) {}
+
+    public:
+        Event(const Event&) noexcept = default;
+        Event& operator=(const Event&) noexcept = default;
+        virtual ~Event() = default;
+
+        std::string_view getType() const noexcept { return event_type_name(typeId); }
+        auto getTimestamp() const noexcept { return timestamp; }
+        EventTypeId getTypeId() const noexcept { return typeId; }
+    };
+
+    // 具体事件类型的基类：class MouseEvent : public EventOf<MouseEvent>
+    template<typename Derived>
+    class EventOf : public Event {
+    protected:
+        EventOf() : Event(event_type_id<Derived>()) {}
+    };
+
+    // 限量处理的结果
+    struct ProcessResult {
+        size_t processed = 0;  // 本次处理的事件数
+        bool pending = false;  // 返回时队列中是否还有事件（包括正在入队的）；具体数目用 getQueueSize()
+    };
+
+    class EventHandler {
+    public:
+        // 限时处理时每处理这么多个事件检查一次时钟
+        static constexpr size_t kClockCheckInterval = 64;
+
+    private:
+        MpscQueue<Event> eventQueue;
+        std::vector<std::function<void(Event&)>> handlers;  // 以 EventTypeId 为下标
+
+        void dispatch(Event& event) {
+            const EventTypeId id = event.getTypeId();
+            if (id < handlers.size() && handlers[id]) {
+                handlers[id](event);
+            }
+        }
+
+    public:
+        EventHandler() = default;
+        EventHandler(const EventHandler&) = delete;
+        EventHandler& operator=(const EventHandler&) = delete;
+
+        ~EventHandler() {
+            while (Event* event = eventQueue.pop()) {
+                delete event;
+            }
+        }
+
+        // 登记 E 类型事件的处理函数，handler 以 E& 调用
+        template<typename E, typename F>
+        void on(F&& handler) {
+            const EventTypeId id = event_type_id<E>();
+            if (id >= handlers.size()) {
+                handlers.resize(id + 1);
+            }
+            handlers[id] = [h = std::forward<F>(handler)](Event& event) mutable {
+                h(static_cast<E&>(event));
+            };
+        }
+
+        // 完美转发添加事件（任意线程）
+        template<typename EventType, typename... Args>
+        void emplace_event(Args&&... args) {
+            eventQueue.push(std::make_unique<EventType>(std::forward<Args>(args)...).release());
+        }
+
+        // 移动语义添加事件（任意线程）
+        void add_event(std::unique_ptr<Event> event) {
+            eventQueue.push(event.release());
+        }
+
+        // 按入队顺序处理并销毁队列中的事件（包括处理期间新加入的），返回处理的事件数。
+        // 同一生产者的事件保持入队顺序；某个生产者正在入队时，它之后的事件留到下一次调用
+        size_t process_events() {
+            size_t processed = 0;
+            while (Event* next = eventQueue.pop()) {
+                std::unique_ptr<Event> event(next);
+                dispatch(*event);
+                ++processed;
+            }
+            return processed;
+        }
+
+        // 最多处理 maxEvents 个事件，且在 timeBudget 用完后停止，先到者为准。
+        // 时钟每 kClockCheckInterval 个事件检查一次，因此只要队列中有事件，至少处理
+        // min(maxEvents, kClockCheckInterval) 个；单个处理函数很慢时可能超出预算
+        template<typename Rep, typename Period>
+        ProcessResult process_events(size_t maxEvents, std::chrono::duration<Rep, Period> timeBudget) {
+            const auto deadline = std::chrono::steady_clock::now() + timeBudget;
+            ProcessResult result;
+            while (result.processed < maxEvents) {
+                Event* next = eventQueue.pop();
+                if (!next) {
+                    break;
+                }
+                std::unique_ptr<Event> event(next);
+                dispatch(*event);
+                if (++result.processed % kClockCheckInterval == 0 && std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+            }
+            result.pending = !eventQueue.empty();
+            return result;
+        }
+
+        // 只能在消费者线程上调用；遍历队列计数，O(n)
+        size_t getQueueSize() const { return eventQueue.size(); }
+    };
+
+}
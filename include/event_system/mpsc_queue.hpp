@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * 侵入式多生产者单消费者队列（Vyukov MPSC）
+ *
+ * 1. 元素从 MpscNode 派生，链接指针就在元素内部，入队不分配内存
+ * 2. push 只有一次 exchange 和一次 store，没有循环也没有锁：生产者是 wait-free 的
+ * 3. pop 只能由一个消费者线程调用。生产者在 exchange 之后、链接之前被挂起时，
+ *    它之后的元素暂时不可见，pop 返回 nullptr，下一次调用再取出（队列不会丢失元素）
+ * 4. 队列内部有一个哨兵节点，空队列时 head 与 tail 都指向它
+ * 5. 队列不维护长度（那需要生产者再做一次原子读改写）：消费者用 empty() O(1) 判断
+ *    是否还有元素，需要具体数目时用 size() 遍历链表
+ *
+ * 出队的元素归调用者所有；队列析构时不释放仍在队列中的元素，由使用者先取空。
+ */
+namespace EventSystem {
+
+    // 入队元素的链接字段：拷贝元素时不拷贝链接
+    struct MpscNode {
+        std::atomic<MpscNode*> next{nullptr};
+
+        MpscNode() noexcept = default;
+        MpscNode(const MpscNode&) noexcept {}
+        MpscNode& operator=(const MpscNode&) noexcept { return *this; }
+    };
+
+    template<typename T>
+    class MpscQueue {
+    private:
+        // 生产者写 head、消费者读写 tail，分开放在不同的缓存行上
+        alignas(64) std::atomic<MpscNode*> head;
+        alignas(64) MpscNode* tail;
+        MpscNode stub;
+
+        void link(MpscNode* node) noexcept {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            MpscNode* prev = head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+    public:
+        MpscQueue() noexcept : head(&stub), tail(&stub) {}
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        // 任意线程调用
+        void push(T* item) noexcept { link(item); }
+
+        // 只能由消费者线程调用；暂时没有可取的元素时返回 nullptr
+        T* pop() noexcept {
+            MpscNode* first = tail;
+            MpscNode* next = first->next.load(std::memory_order_acquire);
+            if (first == &stub) {
+                if (!next) {
+                    return nullptr;
+                }
+                tail = next;
+                first = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+            if (next) {
+                tail = next;
+                return static_cast<T*>(first);
+            }
+            // first 是最后一个已链接的元素：有生产者正在入队时等它链接完再取
+            if (first != head.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            // 放回哨兵，让 first 有后继，之后才能安全地取出 first
+            link(&stub);
+            next = first->next.load(std::memory_order_acquire);
+            if (next) {
+                tail = next;
+                return static_cast<T*>(first);
+            }
+            return nullptr;
+        }
+
+        // 只能由消费者线程调用：没有未取出的元素（包括生产者正在入队、尚未链接的元素）
+        bool empty() const noexcept {
+            return tail == &stub && head.load(std::memory_order_acquire) == &stub;
+        }
+
+        // 只能由消费者线程调用：当前已链接、可以取出的元素数（遍历链表，O(n)）
+        size_t size() const noexcept {
+            size_t count = 0;
+            for (const MpscNode* node = tail; node; node = node->next.load(std::memory_order_acquire)) {
+                count += node != &stub;
+            }
+            return count;
+        }
+    };
+
+}
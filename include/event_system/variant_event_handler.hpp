@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+ * 内联存储的事件处理器 - 封闭事件类型集合的 EventHandler
+ *
+ * 设计要点：
+ * 1. 事件类型在编译期固定（VariantEventHandler<MouseEvent, KeyboardEvent>），
+ *    每个事件以 std::variant<Events...> 的形式按值存放在连续的环形缓冲区中，
+ *    不再为每个事件单独 make_unique，也没有指针跳转
+ * 2. emplace_event 在缓冲区槽位上原地构造事件；process_events 按入队顺序
+ *    std::visit 每个事件，调用该类型登记的处理函数（或传入的访问者），随后原地析构
+ * 3. 缓冲区只在写满时翻倍扩容；容量足够后稳定运行时没有任何堆分配
+ * 4. 处理函数中可以继续 emplace_event：正在处理的事件所在的旧缓冲区保留到
+ *    它处理完为止，扩容不会移动它
+ *
+ * 事件类型必须互不相同，且移动构造不抛出异常（扩容时移动）。
+ * process_events 不可重入；非线程安全。
+ */
+namespace EventSystem {
+
+    template<typename... Events>
+    class VariantEventHandler {
+    public:
+        using EventVariant = std::variant<Events...>;
+
+        static constexpr size_t kDefaultCapacity = 1024;
+
+        static_assert((std::is_nothrow_move_constructible_v<Events> && ...),
+                      "扩容时移动事件，事件的移动构造不能抛出异常");
+
+    private:
+        template<typename E>
+        static constexpr bool is_event_type = (std::is_same_v<E, Events> || ...);
+
+        struct Slot {
+            alignas(EventVariant) std::byte bytes[sizeof(EventVariant)];
+
+            EventVariant* get() noexcept { return std::launder(reinterpret_cast<EventVariant*>(bytes)); }
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        std::unique_ptr<Slot[]> retired;  // 扩容时正在处理的事件所在的旧缓冲区
+        size_t mask;
+        size_t head = 0;  // 单调递增，槽位为 head & mask
+        size_t tail = 0;
+        bool dispatching = false;
+        std::tuple<std::function<void(Events&)>...> handlers;
+
+        void grow() {
+            const size_t capacity = (mask + 1) * 2;
+            auto next = std::make_unique_for_overwrite<Slot[]>(capacity);
+            // 正在处理的事件留在旧缓冲区中，处理完后在原地析构
+            for (size_t i = head + (dispatching ? 1 : 0); i < tail; ++i) {
+                EventVariant* from = slots[i & mask].get();
+                std::construct_at(next[i & (capacity - 1)].get(), std::move(*from));
+                std::destroy_at(from);
+            }
+            // 同一个事件处理期间多次扩容时，只有第一次的旧缓冲区里有它
+            if (dispatching && !retired) {
+                retired = std::move(slots);
+            }
+            slots = std::move(next);
+            mask = capacity - 1;
+        }
+
+        // 处理队首的一个事件；无论 visitor 是否抛出异常，事件都被析构并出队
+        template<typename F>
+        void dispatch_front(F& visitor) {
+            struct Finish {
+                VariantEventHandler& self;
+                EventVariant* event;
+
+                ~Finish() {
+                    std::destroy_at(event);
+                    ++self.head;
+                    self.dispatching = false;
+                    self.retired.reset();
+                }
+            };
+            EventVariant* event = slots[head & mask].get();
+            dispatching = true;
+            Finish finish{*this, event};
+            std::visit(visitor, *event);
+        }
+
+    public:
+        // initialCapacity 向上取 2 的幂
+        explicit VariantEventHandler(size_t initialCapacity = kDefaultCapacity) {
+            size_t capacity = 1;
+            while (capacity < initialCapacity) {
+                capacity <<= 1;
+            }
+            slots = std::make_unique_for_overwrite<Slot[]>(capacity);
+            mask = capacity - 1;
+        }
+
+        VariantEventHandler(const VariantEventHandler&) = delete;
+        VariantEventHandler& operator=(const VariantEventHandler&) = delete;
+
+        ~VariantEventHandler() {
+            for (; head != tail; ++head) {
+                std::destroy_at(slots[head & mask].get());
+            }
+        }
+
+        // 登记 E 类型事件的处理函数，handler 以 E& 调用；重复登记时替换
+        template<typename E, typename F>
+        void on(F&& handler) {
+            static_assert(is_event_type<E>, "E 不在事件类型集合中");
+            std::get<std::function<void(E&)>>(handlers) = std::forward<F>(handler);
+        }
+
+        // 在缓冲区中原地构造 E 类型的事件
+        template<typename E, typename... Args>
+        void emplace_event(Args&&... args) {
+            static_assert(is_event_type<E>, "E 不在事件类型集合中");
+            if (tail - head > mask) {
+                grow();
+            }
+            std::construct_at(slots[tail & mask].get(), std::in_place_type<E>, std::forward<Args>(args)...);
+            ++tail;
+        }
+
+        // 移动（或拷贝）一个已构造的事件进入队列
+        template<typename E>
+        void add_event(E&& event) {
+            emplace_event<std::remove_cvref_t<E>>(std::forward<E>(event));
+        }
+
+        // 按入队顺序以登记的处理函数处理全部事件（包括处理期间新加入的），返回处理的事件数
+        size_t process_events() {
+            auto visitor = [this]<typename E>(E& event) {
+                if (auto& handler = std::get<std::function<void(E&)>>(handlers)) {
+                    handler(event);
+                }
+            };
+            return process_events(visitor);
+        }
+
+        // 以 visitor 代替登记的处理函数：visitor 需要能接受每一种 Events&
+        template<typename F>
+        size_t process_events(F&& visitor) {
+            assert(!dispatching && "process_events 不可重入");
+            size_t processed = 0;
+            while (head != tail) {
+                dispatch_front(visitor);
+                ++processed;
+            }
+            return processed;
+        }
+
+        size_t getQueueSize() const noexcept { return tail - head; }
+        size_t capacity() const noexcept { return mask + 1; }
+    };
+
+}